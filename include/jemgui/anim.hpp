@@ -1,5 +1,6 @@
 #pragma once
 
+#include <jemgui/state_table.hpp>
 #include <jemgui/types.hpp>
 
 namespace jemgui {
@@ -103,17 +104,18 @@ struct anim_slot {
 
 struct anim_pool {
   static constexpr usize max_anims = 32;
-  anim_slot slots[max_anims] = {};
+  state_table<id, anim_slot, max_anims> slots;
 
   void tick(i32 dt_ms) {
-    if (dt_ms <= 0) return;
-    for (usize i = 0; i < max_anims; ++i) {
-      auto& s = slots[i];
+    slots.tick();
+    if (dt_ms <= 0 || active_ == 0) return;
+    for (anim_slot& s : slots) {
       if (!s.active) continue;
       s.elapsed += dt_ms;
       if (s.elapsed >= s.duration) {
         s.current = s.to;
         s.active = false;
+        --active_;
       } else {
         i32 f = ease_apply(s.curve, s.elapsed, s.duration);
         s.current = s.from + ((s.to - s.from) * f >> 8);
@@ -122,84 +124,58 @@ struct anim_pool {
   }
 
   i32 get(id target, i32 fallback) const {
-    for (usize i = 0; i < max_anims; ++i) {
-      if (slots[i].target == target) return slots[i].current;
-    }
-    return fallback;
+    const anim_slot* s = slots.find(target);
+    return s ? s->current : fallback;
   }
 
+  bool any_active() const { return active_ != 0; }
+  u32 active_count() const { return active_; }
+
   bool running(id target) const {
-    for (usize i = 0; i < max_anims; ++i) {
-      if (slots[i].target == target && slots[i].active) return true;
-    }
-    return false;
+    const anim_slot* s = slots.find(target);
+    return s && s->active;
   }
 
   void start(id target, i32 from, i32 to, i32 duration_ms,
              ease curve = ease::out_cubic) {
-    for (usize i = 0; i < max_anims; ++i) {
-      if (slots[i].target == target) {
-        auto& s = slots[i];
-        s.from = s.current;
-        s.to = to;
-        s.elapsed = 0;
-        s.duration = duration_ms;
-        s.curve = curve;
-        s.active = true;
-        return;
-      }
+    bool fresh = !slots.find(target);
+    anim_slot* s = claim(target);
+    if (!s) return;
+    if (fresh) {
+      s->target = target;
+      s->current = from;
     }
-    for (usize i = 0; i < max_anims; ++i) {
-      if (!slots[i].active && slots[i].target == 0) {
-        auto& s = slots[i];
-        s.target = target;
-        s.from = from;
-        s.to = to;
-        s.current = from;
-        s.elapsed = 0;
-        s.duration = duration_ms;
-        s.curve = curve;
-        s.active = true;
-        return;
-      }
-    }
-    usize victim = 0;
-    i32 best_score = -1;
-    for (usize i = 0; i < max_anims; ++i) {
-      if (!slots[i].active) {
-        victim = i;
-        best_score = 0x7FFFFFFF;
-        break;
-      }
-      i32 remaining = slots[i].duration - slots[i].elapsed;
-      if (remaining < best_score || best_score < 0) {
-        best_score = remaining;
-        victim = i;
-      }
-    }
-    auto& s = slots[victim];
-    s.target = target;
-    s.from = from;
-    s.to = to;
-    s.current = from;
-    s.elapsed = 0;
-    s.duration = duration_ms;
-    s.curve = curve;
-    s.active = true;
+    s->from = s->current;
+    s->to = to;
+    s->elapsed = 0;
+    s->duration = duration_ms;
+    s->curve = curve;
+    if (!s->active) ++active_;
+    s->active = true;
   }
 
   void ensure(id target, i32 to, i32 duration_ms,
               ease curve = ease::out_cubic) {
-    for (usize i = 0; i < max_anims; ++i) {
-      if (slots[i].target == target) {
-        if (slots[i].to == to && !slots[i].active) return;
-        if (slots[i].to == to && slots[i].active) return;
-        start(target, slots[i].current, to, duration_ms, curve);
-        return;
-      }
+    anim_slot* s = claim(target);
+    if (!s) return;
+    if (s->target == 0) {
+      s->target = target;
+      s->from = to;
+      s->to = to;
+      s->current = to;
+      return;
     }
-    start(target, to, to, 0, curve);
+    if (s->to != to) start(target, s->current, to, duration_ms, curve);
   }
+
+ private:
+  anim_slot* claim(id target) {
+    return slots.get(target, [this](const anim_slot& old) {
+      if (old.active) --active_;
+    });
+  }
+
+  u32 active_ = 0;
 };
 
 }  // namespace jemgui
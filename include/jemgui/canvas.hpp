@@ -1,7 +1,12 @@
 #pragma once
 
+#include <concepts>
 #include <cstdint>
+#include <cstring>
+#include <utility>
 #include <jemgui/color.hpp>
+#include <jemgui/font.hpp>
+#include <jemgui/stats.hpp>
 #include <jemgui/types.hpp>
 
 namespace jemgui {
@@ -15,12 +20,27 @@ namespace jemgui {
 #define JEMGUI_FRAMEBUF(name, max_w, max_h) \
   JEMGUI_LARGE_BSS static u16 name[(max_w) * (max_h)]
 
+#define JEMGUI_TILEBUF(name, max_w, max_h) \
+  static u32 name[(((max_w) + 15) / 16) * (((max_h) + 15) / 16)]
+
+template <typename D>
+concept async_display = requires(D& d, u16 v, const u16* data) {
+  d.blit_async(v, v, v, v, data);
+  { d.is_busy() } -> std::convertible_to<bool>;
+};
+
+template <typename D>
+concept scroll_display = requires(D& d, u16 v, i16 dy) {
+  { d.scroll_rows(v, v, dy) } -> std::convertible_to<bool>;
+};
+
 template <typename D>
 class canvas {
  public:
-  canvas(D& display, u16* buf)
+  canvas(D& display, u16* buf, u16* back_buf = nullptr)
       : display_{display},
         buf_{buf},
+        back_{back_buf},
         w_{display.width()},
         h_{display.height()} {
     fill_screen(0x0000);
@@ -30,11 +50,13 @@ class canvas {
   u16 height() const { return h_; }
 
   void reinit() {
+    wait();
     w_ = display_.width();
     h_ = display_.height();
     has_clip_ = false;
-    dirty_y0_ = 0;
-    dirty_y1_ = -1;
+    dirty_count_ = 0;
+    scroll_dy_ = 0;
+    tiles_primed_ = false;
     fill_screen(0x0000);
   }
 
@@ -62,32 +84,325 @@ class canvas {
       count -= 8;
     }
     while (count--) *dst++ = word;
-    dirty_y0_ = 0;
-    dirty_y1_ = static_cast<i16>(h_ - 1);
+    dirty_[0] = {0, 0, static_cast<i16>(w_ - 1), static_cast<i16>(h_ - 1)};
+    dirty_count_ = 1;
+    last_dirty_ = 0;
   }
 
   void pixel(i16 x, i16 y, u16 color) {
-    if (static_cast<u16>(x) < w_ && static_cast<u16>(y) < h_) {
-      if (has_clip_ && !clip_.contains({x, y})) return;
-      buf_[y * w_ + x] = color;
-      mark_dirty(y, y);
-    }
+    tally(&paint_stats::pixel, plot(x, y, color));
+  }
+
+  u16 read_pixel(i16 x, i16 y) const {
+    if (static_cast<u16>(x) >= w_ || static_cast<u16>(y) >= h_) return 0;
+    return buf_[y * w_ + x];
   }
 
   void hline(i16 x, i16 y, i16 length, u16 color) {
-    if (static_cast<u16>(y) >= h_ || length <= 0) return;
-    i16 x0 = x < 0 ? static_cast<i16>(0) : x;
-    i16 x1 = static_cast<i16>(x + length - 1);
+    tally(&paint_stats::hline, span(x, y, length, color));
+  }
+
+  void vline(i16 x, i16 y, i16 vh, u16 color) {
+    tally(&paint_stats::vline, column(x, y, vh, color));
+  }
+
+  void fill_rect(i16 x, i16 y, i16 w, i16 h, u16 color) {
+    tally(&paint_stats::fill_rect, fill(x, y, w, h, color));
+  }
+
+  void hline_blend(i16 x, i16 y, i16 length, u16 color, u8 alpha) {
+    tally(&paint_stats::hline,
+          blend_span(x, y, length, color, rgb565_blend{color, alpha}));
+  }
+
+  void fill_rect_blend(i16 x, i16 y, i16 w, i16 h, u16 color, u8 alpha) {
+    rgb565_blend b{color, alpha};
+    i16 y0 = y < 0 ? static_cast<i16>(0) : y;
+    i16 y1 = static_cast<i16>(y + h - 1);
+    if (y1 >= h_) y1 = static_cast<i16>(h_ - 1);
+    u32 n = 0;
+    for (i16 j = y0; j <= y1; ++j) n += blend_span(x, j, w, color, b);
+    tally(&paint_stats::fill_rect, n);
+  }
+
+  void scroll_region(rect r, i16 dx, i16 dy) {
+    rect c = r.intersect({{0, 0}, {w_, h_}});
+    if (has_clip_) c = c.intersect(clip_);
+    rect moved = move_px(buf_, c, dx, dy);
+    if (moved.w() == 0 || defer_scroll(c, dx, dy)) return;
+    mark_dirty(moved.x(), moved.y(), static_cast<i16>(moved.right() - 1),
+               static_cast<i16>(moved.bottom() - 1));
+  }
+
+  void fill_circle(i16 x0, i16 y0, i16 r, u16 color) {
+    u32 n = span(static_cast<i16>(x0 - r), y0, static_cast<i16>(2 * r + 1),
+                 color);
+    i16 f = static_cast<i16>(1 - r);
+    i16 ddx = 1;
+    i16 ddy = static_cast<i16>(-2 * r);
+    i16 px = 0;
+    i16 py = r;
+    while (px < py) {
+      if (f >= 0) {
+        py--;
+        ddy = static_cast<i16>(ddy + 2);
+        f = static_cast<i16>(f + ddy);
+      }
+      px++;
+      ddx = static_cast<i16>(ddx + 2);
+      f = static_cast<i16>(f + ddx);
+      n += span(static_cast<i16>(x0 - px), static_cast<i16>(y0 + py),
+                static_cast<i16>(2 * px + 1), color);
+      n += span(static_cast<i16>(x0 - px), static_cast<i16>(y0 - py),
+                static_cast<i16>(2 * px + 1), color);
+      n += span(static_cast<i16>(x0 - py), static_cast<i16>(y0 + px),
+                static_cast<i16>(2 * py + 1), color);
+      n += span(static_cast<i16>(x0 - py), static_cast<i16>(y0 - px),
+                static_cast<i16>(2 * py + 1), color);
+    }
+    tally(&paint_stats::circle, n);
+  }
+
+  void set_cursor(i16 x, i16 y) {
+    cx_ = x;
+    cy_ = y;
+  }
+
+  void set_text_color(u16 c) { tc_ = c; }
+
+  void set_text_size(u8 s) { ts_ = s; }
+
+  void set_font(const font* f) { text_font_ = f; }
+  const font* text_font() const { return text_font_; }
+
+  void print(const char* str) {
+    if (text_font_) return print_font(str);
+    if (ts_ == 1) return print_small(str);
+    while (*str) {
+      if (*str == '\n') {
+        cx_ = 0;
+        cy_ = static_cast<i16>(cy_ + 8 * ts_);
+      } else {
+        tally(&paint_stats::glyph, draw_glyph(cx_, cy_, *str, tc_, ts_));
+        cx_ = static_cast<i16>(cx_ + 6 * ts_);
+      }
+      str++;
+    }
+  }
+
+  void enable_diff(u32* tile_hashes, usize count) {
+    tile_hash_ = tile_hashes;
+    tile_cap_ = count;
+    tiles_primed_ = false;
+  }
+
+  void disable_diff() { tile_hash_ = nullptr; }
+
+  bool diffing() const {
+    return tile_hash_ != nullptr &&
+           tile_cap_ >= static_cast<usize>(tiles_x()) * tiles_y();
+  }
+
+  void flush() {
+#if JEMGUI_STATS
+    u32 t0 = clock_ ? clock_() : 0;
+#endif
+    wait();
+    if (scroll_dy_ != 0) scroll_display_rows();
+#if JEMGUI_STATS
+    stats_.dirty_rects += static_cast<u32>(dirty_count_);
+    for (usize i = 0; i < dirty_count_; ++i)
+      stats_.dirty_px += dirty_[i].area();
+#endif
+    sending_ = buf_;
+    if (diffing()) {
+      flush_diff();
+    } else {
+      for (usize i = 0; i < dirty_count_; ++i) blit_box(dirty_[i]);
+    }
+    if (async()) {
+      service();
+      for (usize i = 0; i < dirty_count_; ++i) copy_box(dirty_[i]);
+      std::swap(buf_, back_);
+    }
+    dirty_count_ = 0;
+    JEMGUI_STAT(stats_.flush_cycles += clock_ ? clock_() - t0 : 0);
+  }
+
+  bool async() const {
+    if constexpr (async_display<D>) return back_ != nullptr;
+    return false;
+  }
+
+  bool busy() const {
+    if constexpr (async_display<D>)
+      return head_ != tail_ || display_.is_busy();
+    return false;
+  }
+
+  void service() {
+    if constexpr (async_display<D>) {
+      if (in_service_) return;
+      in_service_ = true;
+      if (head_ != tail_ && !display_.is_busy()) start_next();
+      in_service_ = false;
+    }
+  }
+
+  void wait() {
+    while (busy()) service();
+  }
+
+  usize dirty_count() const { return dirty_count_; }
+
+  rect dirty_rect(usize i) const {
+    const auto& b = dirty_[i];
+    return {{b.x0, b.y0},
+            {static_cast<u16>(b.x1 - b.x0 + 1),
+             static_cast<u16>(b.y1 - b.y0 + 1)}};
+  }
+
+#if JEMGUI_STATS
+  const paint_stats& stats() const { return stats_; }
+  void reset_stats() { stats_ = {}; }
+  void set_clock(stats_clock now) { clock_ = now; }
+#endif
+
+ private:
+  void tally([[maybe_unused]] prim_stats paint_stats::*kind,
+             [[maybe_unused]] u32 px) {
+#if JEMGUI_STATS
+    (stats_.*kind).calls++;
+    (stats_.*kind).px += px;
+#endif
+  }
+
+  rect move_px(u16* buf, rect c, i16 dx, i16 dy) const {
+    i16 w = static_cast<i16>(c.w() - (dx < 0 ? -dx : dx));
+    i16 h = static_cast<i16>(c.h() - (dy < 0 ? -dy : dy));
+    if (w <= 0 || h <= 0 || (dx == 0 && dy == 0)) return {};
+    i16 x0 = dx < 0 ? c.x() : static_cast<i16>(c.x() + dx);
+    i16 y0 = dy < 0 ? c.y() : static_cast<i16>(c.y() + dy);
+    i32 from = -(static_cast<i32>(dy) * w_ + dx);
+    usize bytes = static_cast<usize>(w) * sizeof(u16);
+    for (i16 j = 0; j < h; ++j) {
+      i16 y = dy > 0 ? static_cast<i16>(y0 + h - 1 - j)
+                     : static_cast<i16>(y0 + j);
+      u16* dst = buf + y * w_ + x0;
+      std::memmove(dst, dst + from, bytes);
+    }
+    return {{x0, y0}, {static_cast<u16>(w), static_cast<u16>(h)}};
+  }
+
+  bool defer_scroll(rect c, i16 dx, i16 dy) {
+    if constexpr (scroll_display<D>) {
+      if (dx != 0 || c.x() != 0 || c.w() != w_ || scroll_dy_ != 0 ||
+          diffing())
+        return false;
+      rect shifted[max_dirty_rects];
+      usize n = 0;
+      for (usize i = 0; i < dirty_count_; ++i) {
+        rect d = dirty_rect(i).intersect(c);
+        if (d.w() == 0) continue;
+        d.pos.y = static_cast<i16>(d.y() + dy);
+        shifted[n++] = d.intersect(c);
+      }
+      for (usize i = 0; i < n; ++i) {
+        if (shifted[i].w() == 0) continue;
+        mark_dirty(shifted[i].x(), shifted[i].y(),
+                   static_cast<i16>(shifted[i].right() - 1),
+                   static_cast<i16>(shifted[i].bottom() - 1));
+      }
+      i16 ay = dy > 0 ? c.y() : static_cast<i16>(c.bottom() + dy);
+      mark_dirty(0, ay, static_cast<i16>(w_ - 1),
+                 static_cast<i16>(ay + (dy > 0 ? dy : -dy) - 1));
+      scroll_top_ = c.y();
+      scroll_h_ = static_cast<i16>(c.h());
+      scroll_dy_ = dy;
+      return true;
+    }
+    return false;
+  }
+
+  void scroll_display_rows() {
+    if constexpr (scroll_display<D>) {
+      rect area = {{0, scroll_top_}, {w_, static_cast<u16>(scroll_h_)}};
+      if (!display_.scroll_rows(static_cast<u16>(scroll_top_),
+                                static_cast<u16>(scroll_h_), scroll_dy_)) {
+        mark_dirty(0, scroll_top_, static_cast<i16>(w_ - 1),
+                   static_cast<i16>(scroll_top_ + scroll_h_ - 1));
+      } else if (async()) {
+        move_px(back_, area, 0, scroll_dy_);
+      }
+    }
+    scroll_dy_ = 0;
+  }
+
+  u32 plot(i16 x, i16 y, u16 color) {
+    if (static_cast<u16>(x) >= w_ || static_cast<u16>(y) >= h_) return 0;
+    if (has_clip_ && !clip_.contains({x, y})) {
+      JEMGUI_STAT(stats_.clip_rejects++);
+      return 0;
+    }
+    buf_[y * w_ + x] = color;
+    mark_dirty(x, y, x, y);
+    return 1;
+  }
+
+  bool clip_span(i16 x, i16 y, i16 length, i16& x0, i16& x1) {
+    if (static_cast<u16>(y) >= h_ || length <= 0) return false;
+    x0 = x < 0 ? static_cast<i16>(0) : x;
+    x1 = static_cast<i16>(x + length - 1);
     if (x1 >= w_) x1 = static_cast<i16>(w_ - 1);
     if (has_clip_) {
-      if (y < clip_.y() || y >= clip_.bottom()) return;
+      if (y < clip_.y() || y >= clip_.bottom()) {
+        JEMGUI_STAT(stats_.clip_rejects++);
+        return false;
+      }
       if (x0 < clip_.x()) x0 = clip_.x();
       if (x1 >= clip_.right()) x1 = static_cast<i16>(clip_.right() - 1);
     }
-    if (x0 > x1) return;
-    mark_dirty(y, y);
-    u16* p = buf_ + y * w_ + x0;
+    if (x0 > x1) {
+      JEMGUI_STAT(stats_.clip_rejects += has_clip_);
+      return false;
+    }
+    mark_dirty(x0, y, x1, y);
+    return true;
+  }
+
+  u32 span(i16 x, i16 y, i16 length, u16 color) {
+    i16 x0;
+    i16 x1;
+    if (!clip_span(x, y, length, x0, x1)) return 0;
+    i16 n = static_cast<i16>(x1 - x0 + 1);
+    fill_px(buf_ + y * w_ + x0, n, color);
+    return static_cast<u32>(n);
+  }
+
+  u32 blend_span(i16 x, i16 y, i16 length, u16 color, const rgb565_blend& b) {
+    if (b.alpha() == 32) return span(x, y, length, color);
+    i16 x0;
+    i16 x1;
+    if (b.alpha() == 0 || !clip_span(x, y, length, x0, x1)) return 0;
     i16 n = static_cast<i16>(x1 - x0 + 1);
+    blend_px(buf_ + y * w_ + x0, n, b);
+    return static_cast<u32>(n);
+  }
+
+  static void blend_px(u16* p, i16 n, const rgb565_blend& b) {
+    if (n >= 2 && (reinterpret_cast<uintptr_t>(p) & 2)) {
+      *p = b(*p);
+      p++;
+      n--;
+    }
+    u32* wp = reinterpret_cast<u32*>(p);
+    for (i16 pairs = static_cast<i16>(n >> 1); pairs > 0; --pairs, ++wp)
+      *wp = b.pair(*wp);
+    p = reinterpret_cast<u16*>(wp);
+    if (n & 1) *p = b(*p);
+  }
+
+  static void fill_px(u16* p, i16 n, u16 color) {
     if (n >= 4) {
       if (reinterpret_cast<uintptr_t>(p) & 2) {
         *p++ = color;
@@ -112,170 +427,296 @@ class canvas {
     }
   }
 
-  void vline(i16 x, i16 y, i16 vh, u16 color) {
-    if (static_cast<u16>(x) >= w_ || vh <= 0) return;
+  u32 column(i16 x, i16 y, i16 vh, u16 color) {
+    if (static_cast<u16>(x) >= w_ || vh <= 0) return 0;
     i16 y0 = y < 0 ? static_cast<i16>(0) : y;
     i16 y1 = static_cast<i16>(y + vh - 1);
     if (y1 >= h_) y1 = static_cast<i16>(h_ - 1);
     if (has_clip_) {
-      if (x < clip_.x() || x >= clip_.right()) return;
+      if (x < clip_.x() || x >= clip_.right()) {
+        JEMGUI_STAT(stats_.clip_rejects++);
+        return 0;
+      }
       if (y0 < clip_.y()) y0 = clip_.y();
       if (y1 >= clip_.bottom()) y1 = static_cast<i16>(clip_.bottom() - 1);
     }
-    if (y0 > y1) return;
-    mark_dirty(y0, y1);
+    if (y0 > y1) {
+      JEMGUI_STAT(stats_.clip_rejects += has_clip_);
+      return 0;
+    }
+    mark_dirty(x, y0, x, y1);
     u16* p = buf_ + y0 * w_ + x;
     i16 n = static_cast<i16>(y1 - y0 + 1);
+    u32 written = static_cast<u32>(n);
     while (n--) {
       *p = color;
       p += w_;
     }
+    return written;
   }
 
-  void fill_rect(i16 x, i16 y, i16 w, i16 h, u16 color) {
+  u32 fill(i16 x, i16 y, i16 w, i16 h, u16 color) {
     i16 y0 = y < 0 ? static_cast<i16>(0) : y;
     i16 y1 = static_cast<i16>(y + h - 1);
     if (y1 >= h_) y1 = static_cast<i16>(h_ - 1);
-    if (y0 > y1) return;
-    for (i16 j = y0; j <= y1; ++j) hline(x, j, w, color);
+    if (y0 > y1) return 0;
+    u32 n = 0;
+    for (i16 j = y0; j <= y1; ++j) n += span(x, j, w, color);
+    return n;
   }
 
-  void fill_circle(i16 x0, i16 y0, i16 r, u16 color) {
-    hline(static_cast<i16>(x0 - r), y0, static_cast<i16>(2 * r + 1), color);
-    i16 f = static_cast<i16>(1 - r);
-    i16 ddx = 1;
-    i16 ddy = static_cast<i16>(-2 * r);
-    i16 px = 0;
-    i16 py = r;
-    while (px < py) {
-      if (f >= 0) {
-        py--;
-        ddy = static_cast<i16>(ddy + 2);
-        f = static_cast<i16>(f + ddy);
-      }
-      px++;
-      ddx = static_cast<i16>(ddx + 2);
-      f = static_cast<i16>(f + ddx);
-      hline(static_cast<i16>(x0 - px), static_cast<i16>(y0 + py),
-            static_cast<i16>(2 * px + 1), color);
-      hline(static_cast<i16>(x0 - px), static_cast<i16>(y0 - py),
-            static_cast<i16>(2 * px + 1), color);
-      hline(static_cast<i16>(x0 - py), static_cast<i16>(y0 + px),
-            static_cast<i16>(2 * py + 1), color);
-      hline(static_cast<i16>(x0 - py), static_cast<i16>(y0 - px),
-            static_cast<i16>(2 * py + 1), color);
-    }
-  }
-
-  void set_cursor(i16 x, i16 y) {
-    cx_ = x;
-    cy_ = y;
+  static constexpr bool font_bit(char c, u8 col, u8 row) {
+    if (c < 32 || c > 126 || col >= 5 || row >= 8) return false;
+    return (font_[(c - 32) * 5 + col] >> row) & 1;
   }
 
-  void set_text_color(u16 c) { tc_ = c; }
-
-  void set_text_size(u8 s) { ts_ = s; }
+  void print_font(const char* str) {
+    const font& f = *text_font_;
+    i16 cx0 = 0;
+    i16 cy0 = 0;
+    i16 cx1 = static_cast<i16>(w_);
+    i16 cy1 = static_cast<i16>(h_);
+    if (has_clip_) {
+      cx0 = std::max(cx0, clip_.x());
+      cy0 = std::max(cy0, clip_.y());
+      cx1 = std::min(cx1, clip_.right());
+      cy1 = std::min(cy1, clip_.bottom());
+    }
 
-  void print(const char* str) {
-    while (*str) {
+    dirty_box box = {static_cast<i16>(w_), static_cast<i16>(h_), -1, -1};
+    for (; *str; ++str) {
       if (*str == '\n') {
         cx_ = 0;
-        cy_ = static_cast<i16>(cy_ + 8 * ts_);
-      } else {
-        draw_glyph(cx_, cy_, *str, tc_, ts_);
-        cx_ = static_cast<i16>(cx_ + 6 * ts_);
+        cy_ = static_cast<i16>(cy_ + f.line_height);
+        continue;
       }
-      str++;
+      const font_glyph* g = find_glyph(f, *str);
+      if (!g) continue;
+      i16 gx = static_cast<i16>(cx_ + g->x);
+      i16 gy = static_cast<i16>(cy_ + g->y);
+      cx_ = static_cast<i16>(cx_ + g->advance);
+      if (g->w == 0 || g->h == 0) continue;
+
+      i16 x0 = std::max(gx, cx0);
+      i16 y0 = std::max(gy, cy0);
+      i16 x1 = std::min(static_cast<i16>(gx + g->w), cx1);
+      i16 y1 = std::min(static_cast<i16>(gy + g->h), cy1);
+      if (x0 >= x1 || y0 >= y1) {
+        JEMGUI_STAT(stats_.clip_rejects += has_clip_);
+        tally(&paint_stats::glyph, 0);
+        continue;
+      }
+
+      [[maybe_unused]] u32 n = 0;
+      for (i16 y = y0; y < y1; ++y) {
+        u32 i = static_cast<u32>(y - gy) * g->w + static_cast<u32>(x0 - gx);
+        u16* p = buf_ + y * w_ + x0;
+        for (i16 x = x0; x < x1; ++x, ++i, ++p) {
+          u8 a = glyph_coverage(f, *g, i);
+          if (a == 0) continue;
+          *p = a == 255 ? tc_ : blend_rgb565(tc_, *p, a);
+          JEMGUI_STAT(n++);
+        }
+      }
+      tally(&paint_stats::glyph, n);
+      box = box.merged({x0, y0, static_cast<i16>(x1 - 1),
+                        static_cast<i16>(y1 - 1)});
     }
+    if (box.x0 <= box.x1) mark_dirty(box.x0, box.y0, box.x1, box.y1);
   }
 
-  void flush() {
-    if (dirty_y0_ <= dirty_y1_) {
-      u16 band_h = static_cast<u16>(dirty_y1_ - dirty_y0_ + 1);
-      display_.blit(0, static_cast<u16>(dirty_y0_), w_, band_h,
-                    buf_ + dirty_y0_ * w_);
-      dirty_y0_ = static_cast<i16>(h_);
-      dirty_y1_ = -1;
+  void print_small(const char* str) {
+    i16 cx0 = 0;
+    i16 cy0 = 0;
+    i16 cx1 = static_cast<i16>(w_ - 1);
+    i16 cy1 = static_cast<i16>(h_ - 1);
+    if (has_clip_) {
+      cx0 = std::max(cx0, clip_.x());
+      cy0 = std::max(cy0, clip_.y());
+      cx1 = std::min(cx1, static_cast<i16>(clip_.right() - 1));
+      cy1 = std::min(cy1, static_cast<i16>(clip_.bottom() - 1));
     }
-  }
 
- private:
-  bool font_bit(char c, u8 col, u8 row) const {
-    if (c < 32 || c > 126 || col >= 5 || row >= 8) return false;
-    return (font_[(c - 32) * 5 + col] >> row) & 1;
-  }
+    dirty_box box = {static_cast<i16>(w_), static_cast<i16>(h_), -1, -1};
+    for (; *str; ++str) {
+      char c = *str;
+      i16 x = cx_;
+      i16 y = cy_;
+      if (c == '\n') {
+        cx_ = 0;
+        cy_ = static_cast<i16>(cy_ + 8);
+        continue;
+      }
+      cx_ = static_cast<i16>(cx_ + 6);
+      if (c < 32 || c > 126) continue;
+      if (x > cx1 || x + 4 < cx0 || y > cy1 || y + 7 < cy0) {
+        JEMGUI_STAT(stats_.clip_rejects += has_clip_);
+        tally(&paint_stats::glyph, 0);
+        continue;
+      }
 
-  void draw_glyph(i16 x, i16 y, char c, u16 fg, u8 sz) {
-    if (c < 32 || c > 126) return;
-    if (sz == 1) {
-      for (u8 i = 0; i < 5; i++) {
-        u8 line = font_[(c - 32) * 5 + i];
-        for (u8 j = 0; j < 8; j++) {
-          if (line & 0x01)
-            pixel(static_cast<i16>(x + i), static_cast<i16>(y + j), fg);
+      i16 i0 = static_cast<i16>(std::max(0, cx0 - x));
+      i16 i1 = static_cast<i16>(std::min(4, cx1 - x));
+      i16 j0 = static_cast<i16>(std::max(0, cy0 - y));
+      i16 j1 = static_cast<i16>(std::min(7, cy1 - y));
+      u8 mask = static_cast<u8>((0xFF >> (7 - j1)) & (0xFF << j0));
+      const u8* glyph = font_ + (c - 32) * 5;
+      u16* top = buf_ + (y + j0) * w_ + x + i0;
+      u8 any = 0;
+      [[maybe_unused]] u32 n = 0;
+      for (i16 i = i0; i <= i1; ++i) {
+        u8 line = static_cast<u8>((glyph[i] & mask) >> j0);
+        any |= line;
+        u16* p = top + (i - i0);
+        while (line) {
+          if (line & 1) {
+            *p = tc_;
+            JEMGUI_STAT(n++);
+          }
           line >>= 1;
+          p += w_;
         }
       }
-      return;
+      tally(&paint_stats::glyph, n);
+      if (!any) continue;
+      box = box.merged({static_cast<i16>(x + i0), static_cast<i16>(y + j0),
+                        static_cast<i16>(x + i1), static_cast<i16>(y + j1)});
     }
+    if (box.x0 <= box.x1) mark_dirty(box.x0, box.y0, box.x1, box.y1);
+  }
 
-    for (u8 i = 0; i < 5; i++) {
-      u8 line = font_[(c - 32) * 5 + i];
-      for (u8 j = 0; j < 8; j++) {
-        if (line & 0x01) {
-          fill_rect(static_cast<i16>(x + i * sz), static_cast<i16>(y + j * sz),
-                    sz, sz, fg);
-        }
-        line >>= 1;
-      }
-    }
+  static constexpr usize glyph_cache_size = 16;
 
-    if (sz < 2) return;
+  enum : u8 { edge_tl, edge_tl2, edge_tr, edge_bl };
+
+  struct glyph_shape {
+    char c = 0;
+    u8 edges = 0;
+    u8 rows[8] = {};
+    u8 edge[30] = {};
+  };
+
+  template <typename F>
+  static constexpr void glyph_edges(char c, F&& add) {
     for (u8 i = 0; i < 5; i++) {
       for (u8 j = 0; j < 8; j++) {
-        bool me = font_bit(c, i, j);
-        if (me) continue;
-
+        if (font_bit(c, i, j)) continue;
         bool left = font_bit(c, static_cast<u8>(i - 1), j);
         bool right = font_bit(c, static_cast<u8>(i + 1), j);
         bool up = font_bit(c, i, static_cast<u8>(j - 1));
         bool down = font_bit(c, i, static_cast<u8>(j + 1));
+        bool tl = left && !right;
+        bool tl2 = up && !down;
+        if (tl && tl2)
+          add(i, j, edge_tl2);
+        else if (tl || tl2)
+          add(i, j, edge_tl);
+        if (right && !left) add(i, j, edge_tr);
+        if (down && !up) add(i, j, edge_bl);
+      }
+    }
+  }
 
-        if (!left && !right && !up && !down) continue;
-
-        i16 bx = static_cast<i16>(x + i * sz);
-        i16 by = static_cast<i16>(y + j * sz);
+  static consteval usize max_glyph_edges() {
+    usize most = 0;
+    for (int c = 32; c <= 126; ++c) {
+      usize n = 0;
+      glyph_edges(static_cast<char>(c), [&](u8, u8, u8) { ++n; });
+      most = std::max(most, n);
+    }
+    return most;
+  }
 
-        auto read_bg = [&](i16 px, i16 py) -> u16 {
-          if (static_cast<u16>(px) < w_ && static_cast<u16>(py) < h_)
-            return buf_[py * w_ + px];
-          return 0;
-        };
+  const glyph_shape& shape(char c) {
+    static_assert(sizeof(glyph_shape::edge) == max_glyph_edges(),
+                  "glyph_shape::edge is sized for the busiest built-in glyph");
+    for (const auto& g : glyph_cache_)
+      if (g.c == c) return g;
+
+    glyph_shape& g = glyph_cache_[glyph_next_];
+    glyph_next_ = static_cast<u8>((glyph_next_ + 1) % glyph_cache_size);
+    g.c = c;
+    g.edges = 0;
+    for (u8 j = 0; j < 8; j++) {
+      g.rows[j] = 0;
+      for (u8 i = 0; i < 5; i++)
+        if (font_bit(c, i, j)) g.rows[j] |= static_cast<u8>(1 << i);
+    }
+    glyph_edges(c, [&](u8 i, u8 j, u8 kind) {
+      g.edge[g.edges++] = static_cast<u8>(i | (j << 3) | (kind << 6));
+    });
+    return g;
+  }
 
-        if (left && !right) {
-          u16 bg = read_bg(bx, by);
-          u16 blend = blend_rgb565(fg, bg, 80);
-          pixel(bx, by, blend);
-        }
-        if (right && !left) {
-          i16 ex = static_cast<i16>(bx + sz - 1);
-          u16 bg = read_bg(ex, by);
-          u16 blend = blend_rgb565(fg, bg, 80);
-          pixel(ex, by, blend);
+  u32 draw_glyph(i16 x, i16 y, char c, u16 fg, u8 sz) {
+    if (c < 32 || c > 126) return 0;
+    i16 gw = static_cast<i16>(5 * sz);
+    i16 gh = static_cast<i16>(8 * sz);
+    i16 cx0 = has_clip_ ? std::max<i16>(0, clip_.x()) : 0;
+    i16 cy0 = has_clip_ ? std::max<i16>(0, clip_.y()) : 0;
+    i16 cx1 = static_cast<i16>(w_);
+    i16 cy1 = static_cast<i16>(h_);
+    if (has_clip_) {
+      cx1 = std::min(cx1, clip_.right());
+      cy1 = std::min(cy1, clip_.bottom());
+    }
+    if (x >= cx1 || x + gw <= cx0 || y >= cy1 || y + gh <= cy0) {
+      JEMGUI_STAT(stats_.clip_rejects += has_clip_);
+      return 0;
+    }
+    bool inside = x >= cx0 && x + gw <= cx1 && y >= cy0 && y + gh <= cy1;
+
+    const glyph_shape& g = shape(c);
+    u32 n = 0;
+    for (u8 j = 0; j < 8; j++) {
+      u8 bits = g.rows[j];
+      u8 i = 0;
+      while (bits) {
+        while (!(bits & 1)) {
+          bits >>= 1;
+          i++;
         }
-        if (up && !down) {
-          u16 bg = read_bg(bx, by);
-          u16 blend = blend_rgb565(fg, bg, 80);
-          pixel(bx, by, blend);
+        u8 i0 = i;
+        while (bits & 1) {
+          bits >>= 1;
+          i++;
         }
-        if (down && !up) {
-          i16 ey = static_cast<i16>(by + sz - 1);
-          u16 bg = read_bg(bx, ey);
-          u16 blend = blend_rgb565(fg, bg, 80);
-          pixel(bx, ey, blend);
+        i16 rx = static_cast<i16>(x + i0 * sz);
+        i16 rw = static_cast<i16>((i - i0) * sz);
+        i16 ry = static_cast<i16>(y + j * sz);
+        for (u8 k = 0; k < sz; k++) {
+          if (inside) {
+            fill_px(buf_ + (ry + k) * w_ + rx, rw, fg);
+            n += static_cast<u32>(rw);
+          } else {
+            n += span(rx, static_cast<i16>(ry + k), rw, fg);
+          }
         }
       }
     }
+
+    for (u8 e = 0; e < g.edges; e++) {
+      u8 kind = static_cast<u8>(g.edge[e] >> 6);
+      i16 px = static_cast<i16>(x + (g.edge[e] & 7) * sz);
+      i16 py = static_cast<i16>(y + ((g.edge[e] >> 3) & 7) * sz);
+      if (kind == edge_tr) px = static_cast<i16>(px + sz - 1);
+      if (kind == edge_bl) py = static_cast<i16>(py + sz - 1);
+      u8 times = kind == edge_tl2 ? 2 : 1;
+      if (inside) {
+        u16& d = buf_[py * w_ + px];
+        while (times--) d = blend_rgb565(fg, d, 80);
+        n++;
+      } else if (static_cast<u16>(px) < w_ && static_cast<u16>(py) < h_) {
+        while (times--)
+          n += plot(px, py, blend_rgb565(fg, buf_[py * w_ + px], 80));
+      }
+    }
+
+    if (inside && n > 0) {
+      mark_dirty(x, y, static_cast<i16>(x + gw - 1),
+                 static_cast<i16>(y + gh - 1));
+    }
+    return n;
   }
 
   // clang-format off
@@ -333,18 +774,232 @@ class canvas {
 
   rect clip_ = {};
   bool has_clip_ = false;
+  glyph_shape glyph_cache_[glyph_cache_size] = {};
+  u8 glyph_next_ = 0;
+
+#if JEMGUI_STATS
+  paint_stats stats_ = {};
+  stats_clock clock_ = nullptr;
+#endif
+
+  static constexpr usize max_dirty_rects = 8;
+
+  struct dirty_box {
+    i16 x0 = 0;
+    i16 y0 = 0;
+    i16 x1 = -1;
+    i16 y1 = -1;
+
+    u32 area() const {
+      return static_cast<u32>(x1 - x0 + 1) * static_cast<u32>(y1 - y0 + 1);
+    }
+
+    bool contains(const dirty_box& o) const {
+      return o.x0 >= x0 && o.x1 <= x1 && o.y0 >= y0 && o.y1 <= y1;
+    }
+
+    bool touches(const dirty_box& o) const {
+      return o.x0 <= x1 + 1 && x0 <= o.x1 + 1 && o.y0 <= y1 + 1 &&
+             y0 <= o.y1 + 1;
+    }
+
+    dirty_box merged(const dirty_box& o) const {
+      return {std::min(x0, o.x0), std::min(y0, o.y0), std::max(x1, o.x1),
+              std::max(y1, o.y1)};
+    }
+
+    bool joins(const dirty_box& o) const {
+      return touches(o) && merged(o).area() <=
+                               area() + o.area() + std::min(area(), o.area());
+    }
+  };
+
+  void mark_dirty(i16 x0, i16 y0, i16 x1, i16 y1) {
+    dirty_box b = {x0, y0, x1, y1};
+    if (dirty_count_ > 0 && dirty_[last_dirty_].contains(b)) return;
+
+    while (true) {
+      usize i = 0;
+      while (i < dirty_count_) {
+        if (dirty_[i].joins(b)) {
+          b = b.merged(dirty_[i]);
+          dirty_[i] = dirty_[--dirty_count_];
+          i = 0;
+        } else {
+          ++i;
+        }
+      }
+      if (dirty_count_ < max_dirty_rects) break;
+
+      usize best = 0;
+      u32 best_cost = 0xFFFFFFFF;
+      for (usize j = 0; j < dirty_count_; ++j) {
+        u32 cost = b.merged(dirty_[j]).area() - dirty_[j].area();
+        if (cost < best_cost) {
+          best_cost = cost;
+          best = j;
+        }
+      }
+      b = b.merged(dirty_[best]);
+      dirty_[best] = dirty_[--dirty_count_];
+    }
+
+    last_dirty_ = dirty_count_;
+    dirty_[dirty_count_++] = b;
+  }
+
+  static constexpr u16 max_pending = 16;
 
-  void mark_dirty(i16 y0, i16 y1) {
-    if (y0 < dirty_y0_) dirty_y0_ = y0;
-    if (y1 > dirty_y1_) dirty_y1_ = y1;
+  void copy_box(const dirty_box& b) {
+    usize n = static_cast<usize>(b.x1 - b.x0 + 1) * sizeof(u16);
+    for (i16 y = b.y0; y <= b.y1; ++y) {
+      usize at = static_cast<usize>(y) * w_ + static_cast<usize>(b.x0);
+      std::memcpy(back_ + at, buf_ + at, n);
+    }
+  }
+
+  void start_next() {
+    const dirty_box& b = pending_[head_ % max_pending];
+    u16 x = static_cast<u16>(b.x0);
+    u16 y = static_cast<u16>(b.y0);
+    u16 bw = static_cast<u16>(b.x1 - b.x0 + 1);
+    u16 bh = static_cast<u16>(b.y1 - b.y0 + 1);
+    const u16* src = sending_ + y * w_ + x;
+    if constexpr (requires { display_.blit_async(x, y, bw, bh, src, w_); }) {
+      display_.blit_async(x, y, bw, bh, src, w_);
+      head_ = static_cast<u16>(head_ + 1);
+    } else if (bw == w_) {
+      display_.blit_async(x, y, bw, bh, src);
+      head_ = static_cast<u16>(head_ + 1);
+    } else {
+      u16 row = row_;
+      display_.blit_async(x, static_cast<u16>(y + row), bw, 1,
+                          src + row * w_);
+      if (++row == bh) {
+        row_ = 0;
+        head_ = static_cast<u16>(head_ + 1);
+      } else {
+        row_ = row;
+      }
+    }
+  }
+
+  void blit_box(const dirty_box& b) {
+    if constexpr (async_display<D>) {
+      if (back_) {
+        while (static_cast<u16>(tail_ - head_) == max_pending) service();
+        pending_[tail_ % max_pending] = b;
+        tail_ = static_cast<u16>(tail_ + 1);
+        return;
+      }
+    }
+    u16 x = static_cast<u16>(b.x0);
+    u16 y = static_cast<u16>(b.y0);
+    u16 bw = static_cast<u16>(b.x1 - b.x0 + 1);
+    u16 bh = static_cast<u16>(b.y1 - b.y0 + 1);
+    const u16* src = buf_ + y * w_ + x;
+    if constexpr (requires { display_.blit(x, y, bw, bh, src, w_); }) {
+      display_.blit(x, y, bw, bh, src, w_);
+    } else if (bw == w_) {
+      display_.blit(x, y, bw, bh, src);
+    } else {
+      for (u16 j = 0; j < bh; ++j) {
+        display_.blit(x, static_cast<u16>(y + j), bw, 1, src);
+        src += w_;
+      }
+    }
+  }
+
+  static constexpr u16 diff_tile = 16;
+
+  u16 tiles_x() const {
+    return static_cast<u16>((w_ + diff_tile - 1) / diff_tile);
+  }
+
+  u16 tiles_y() const {
+    return static_cast<u16>((h_ + diff_tile - 1) / diff_tile);
+  }
+
+  u32 hash_tile(u16 tx, u16 ty) const {
+    u16 x0 = static_cast<u16>(tx * diff_tile);
+    u16 y0 = static_cast<u16>(ty * diff_tile);
+    u16 tw = std::min<u16>(diff_tile, static_cast<u16>(w_ - x0));
+    u16 th = std::min<u16>(diff_tile, static_cast<u16>(h_ - y0));
+    const u16* row = buf_ + y0 * w_ + x0;
+    u32 h = 2166136261u;
+    for (u16 j = 0; j < th; ++j) {
+      for (u16 i = 0; i < tw; ++i) h = (h ^ row[i]) * 16777619u;
+      row += w_;
+    }
+    return h;
+  }
+
+  void blit_tiles(u16 tx0, u16 tx1, u16 ty) {
+    dirty_box b = {
+        static_cast<i16>(tx0 * diff_tile),
+        static_cast<i16>(ty * diff_tile),
+        static_cast<i16>(std::min<i32>((tx1 + 1) * diff_tile, w_) - 1),
+        static_cast<i16>(std::min<i32>((ty + 1) * diff_tile, h_) - 1),
+    };
+    blit_box(b);
+  }
+
+  void flush_diff() {
+    u16 ntx = tiles_x();
+    if (!tiles_primed_) {
+      for (usize i = 0; i < dirty_count_; ++i) blit_box(dirty_[i]);
+      for (u16 ty = 0; ty < tiles_y(); ++ty)
+        for (u16 tx = 0; tx < ntx; ++tx)
+          tile_hash_[ty * ntx + tx] = hash_tile(tx, ty);
+      tiles_primed_ = true;
+      return;
+    }
+
+    for (usize i = 0; i < dirty_count_; ++i) {
+      const auto& b = dirty_[i];
+      u16 tx0 = static_cast<u16>(b.x0 / diff_tile);
+      u16 tx1 = static_cast<u16>(b.x1 / diff_tile);
+      u16 ty0 = static_cast<u16>(b.y0 / diff_tile);
+      u16 ty1 = static_cast<u16>(b.y1 / diff_tile);
+      for (u16 ty = ty0; ty <= ty1; ++ty) {
+        i32 run = -1;
+        for (u16 tx = tx0; tx <= tx1; ++tx) {
+          u32 h = hash_tile(tx, ty);
+          u32& slot = tile_hash_[ty * ntx + tx];
+          if (h != slot) {
+            slot = h;
+            if (run < 0) run = tx;
+          } else if (run >= 0) {
+            blit_tiles(static_cast<u16>(run), static_cast<u16>(tx - 1), ty);
+            run = -1;
+          }
+        }
+        if (run >= 0) blit_tiles(static_cast<u16>(run), tx1, ty);
+      }
+    }
   }
 
   D& display_;
   u16* buf_;
+  u16* back_;
+  const u16* sending_ = nullptr;
   u16 w_;
   u16 h_;
-  i16 dirty_y0_ = 0;
-  i16 dirty_y1_ = -1;
+  dirty_box dirty_[max_dirty_rects] = {};
+  usize dirty_count_ = 0;
+  usize last_dirty_ = 0;
+  i16 scroll_top_ = 0;
+  i16 scroll_h_ = 0;
+  i16 scroll_dy_ = 0;
+  u32* tile_hash_ = nullptr;
+  usize tile_cap_ = 0;
+  bool tiles_primed_ = false;
+  dirty_box pending_[max_pending] = {};
+  volatile u16 head_ = 0;
+  volatile u16 tail_ = 0;
+  volatile u16 row_ = 0;
+  volatile bool in_service_ = false;
+  const font* text_font_ = nullptr;
   i16 cx_ = 0;
   i16 cy_ = 0;
   u16 tc_ = 0xFFFF;
@@ -18,6 +18,8 @@ constexpr u8 rgb565_g(u16 c) {
 
 constexpr u8 rgb565_b(u16 c) { return static_cast<u8>((c & 0x1F) * 255 / 31); }
 
+constexpr u32 div255(u32 x) { return (x + 1 + (x >> 8)) >> 8; }
+
 constexpr u16 blend_rgb565(u16 fg, u16 bg, u8 alpha) {
   u32 fr = (fg >> 11) & 0x1F;
   u32 fg_ = (fg >> 5) & 0x3F;
@@ -26,12 +28,43 @@ constexpr u16 blend_rgb565(u16 fg, u16 bg, u8 alpha) {
   u32 bg_ = (bg >> 5) & 0x3F;
   u32 bb = bg & 0x1F;
   u32 inv = 255 - alpha;
-  u32 r = (fr * alpha + br * inv) / 255;
-  u32 g = (fg_ * alpha + bg_ * inv) / 255;
-  u32 b = (fb * alpha + bb * inv) / 255;
+  u32 r = div255(fr * alpha + br * inv);
+  u32 g = div255(fg_ * alpha + bg_ * inv);
+  u32 b = div255(fb * alpha + bb * inv);
   return static_cast<u16>((r << 11) | (g << 5) | b);
 }
 
+class rgb565_blend {
+ public:
+  constexpr rgb565_blend(u16 color, u8 alpha)
+      : a_{static_cast<u32>((alpha + 4) >> 3)}, inv_{32 - a_} {
+    u32 pair = (static_cast<u32>(color) << 16) | color;
+    lo_ = (pair & lo_mask) * a_;
+    hi_ = ((pair >> 5) & hi_mask) * a_;
+  }
+
+  constexpr u32 alpha() const { return a_; }
+
+  constexpr u32 pair(u32 under) const {
+    u32 lo = (((under & lo_mask) * inv_ + lo_) >> 5) & lo_mask;
+    u32 hi = ((((under >> 5) & hi_mask) * inv_ + hi_) >> 5) & hi_mask;
+    return lo | (hi << 5);
+  }
+
+  constexpr u16 operator()(u16 under) const {
+    return static_cast<u16>(pair(under));
+  }
+
+ private:
+  static constexpr u32 lo_mask = 0x07E0F81F;
+  static constexpr u32 hi_mask = 0x07C0F83F;
+
+  u32 a_;
+  u32 inv_;
+  u32 lo_ = 0;
+  u32 hi_ = 0;
+};
+
 constexpr u16 darken(u16 c, u8 amount) {
   u32 r = (c >> 11) & 0x1F;
   u32 g = (c >> 5) & 0x3F;
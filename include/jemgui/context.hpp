@@ -1,15 +1,17 @@
 #pragma once
 
 #include <algorithm>
-#include <cstdarg>
-#include <cstdio>
 #include <jemgui/anim.hpp>
 #include <jemgui/color.hpp>
 #include <jemgui/draw.hpp>
+#include <jemgui/format.hpp>
 #include <jemgui/hash.hpp>
 #include <jemgui/input.hpp>
 #include <jemgui/layout.hpp>
 #include <jemgui/painter.hpp>
+#include <jemgui/plot.hpp>
+#include <jemgui/state_table.hpp>
+#include <jemgui/stats.hpp>
 #include <jemgui/theme.hpp>
 #include <jemgui/types.hpp>
 #include <jemgui/widgets.hpp>
@@ -24,19 +26,69 @@ class ctx {
     recalculate_scale();
   }
 
-  void set_theme(const theme& t) { theme_ = t; }
+  void set_theme(const theme& t) {
+    theme_ = t;
+    clear_text_cache();
+    force_paint_ = true;
+  }
   const theme& current_theme() const { return theme_; }
 
+  void set_font(const font* f)
+    requires font_painter<P>
+  {
+    p_.set_font(f);
+    clear_text_cache();
+    force_paint_ = true;
+  }
+
   void recalculate() {
     recalculate_scale();
-    for (usize i = 0; i < max_scroll_panels; ++i) scroll_[i] = {};
+    clear_text_cache();
+    scroll_.clear();
+    plots_.clear();
+    force_paint_ = true;
   }
 
+  // the skip decision uses the previous frame's hash, so a change with no
+  // input or animation behind it shows one frame late unless the app calls
+  // invalidate() before begin_frame().
+  void set_frame_skip(bool on) {
+    frame_skip_ = on;
+    force_paint_ = true;
+  }
+
+  void invalidate() { force_paint_ = true; }
+
+  bool painting() const { return painting_; }
+
+  void track(u32 value) { frame_hash_ = mix_id(frame_hash_, value); }
+
   void begin_frame(const input_state& input, i32 dt_ms = 0) {
+#if JEMGUI_STATS
+    u32 t0 = ticks();
+    last_stats_ = stats_;
+    if constexpr (requires { p_.stats(); }) {
+      last_stats_.paint = p_.stats();
+      p_.reset_stats();
+    }
+    stats_ = {};
+#endif
     input_.update(input);
+    painting_ = !frame_skip_ || force_paint_ || !can_skip_ || input_.down() ||
+                input_.released() || anims_.any_active();
+    if (force_paint_) {
+      for (scroll_entry& e : scroll_) e.drawn = false;
+      for (plot_entry& e : plots_) e.drawn = false;
+    }
+    force_paint_ = false;
+    frame_hash_ = 2166136261u;
+    scroll_.tick();
+    plots_.tick();
     anims_.tick(dt_ms);
     hot_ = 0;
-    active_panel_.scroll_idx = -1;
+    if (!input_.down()) drag_ = 0;
+    active_panel_.scroll = nullptr;
+    clip_depth_ = 0;
     layout_.reset();
     container root{};
     root.bounds = rect{{0, 0}, {p_.width(), p_.height()}};
@@ -47,16 +99,116 @@ class ctx {
 
     i16 pw = static_cast<i16>(p_.width());
     i16 ph = static_cast<i16>(p_.height());
-    i16 edge = static_cast<i16>(s(theme_.padding) + s(theme_.corner_radius));
-    p_.fill_rect(0, 0, pw, edge, theme_.bg);
-    p_.fill_rect(0, static_cast<i16>(ph - edge), pw, edge, theme_.bg);
-    p_.fill_rect(0, edge, edge, static_cast<i16>(ph - 2 * edge), theme_.bg);
-    p_.fill_rect(static_cast<i16>(pw - edge), edge, edge,
-                 static_cast<i16>(ph - 2 * edge), theme_.bg);
+    i16 edge = root_edge();
+    if (paint(0, root.bounds, theme_.bg)) {
+      extent across = {p_.width(), static_cast<u16>(edge)};
+      extent down = {static_cast<u16>(edge), static_cast<u16>(ph - 2 * edge)};
+      const rect edges[] = {
+          {{0, 0}, across},
+          {{0, static_cast<i16>(ph - edge)}, across},
+          {{0, edge}, down},
+          {{static_cast<i16>(pw - edge), edge}, down},
+      };
+      for (scroll_entry& e : scroll_) e.held = e.drawn && reusable(e);
+      for (const rect& e : edges) fill_edge(e);
+    }
+#if JEMGUI_STATS
+    widgets_t0_ = ticks();
+    stats_.begin_cycles = widgets_t0_ - t0;
+#endif
   }
 
   void end_frame() {
+#if JEMGUI_STATS
+    u32 t0 = ticks();
+    stats_.widget_cycles = t0 - widgets_t0_;
+#endif
     if (!input_.down()) active_ = 0;
+    for (scroll_entry& e : scroll_) {
+      force_paint_ = force_paint_ || e.held;
+      e.held = false;
+    }
+    can_skip_ = frame_hash_ == last_hash_;
+    last_hash_ = frame_hash_;
+#if JEMGUI_STATS
+    stats_.anims_active = anims_.active_count();
+    stats_.end_cycles = ticks() - t0;
+#endif
+  }
+
+#if JEMGUI_STATS
+  void set_clock(stats_clock now) {
+    clock_ = now;
+    if constexpr (requires { p_.set_clock(now); }) p_.set_clock(now);
+  }
+
+  const frame_stats& stats() const { return last_stats_; }
+
+  void stats_overlay() {
+    const frame_stats& st = last_stats_;
+    const paint_stats& ps = st.paint;
+    constexpr usize lines = 7;
+    char text[lines][32];
+    format_to(text[0], "px {} rej {}", ps.total_px(), ps.clip_rejects);
+    format_to(text[1], "rect {} hl {}", ps.fill_rect.calls, ps.hline.calls);
+    format_to(text[2], "vl {} pix {}", ps.vline.calls, ps.pixel.calls);
+    format_to(text[3], "glyph {} circ {}", ps.glyph.calls, ps.circle.calls);
+    format_to(text[4], "dirty {}/{}", ps.dirty_rects, ps.dirty_px);
+    format_to(text[5], "wdg {} anim {}", st.widgets, st.anims_active);
+    format_to(text[6], "cyc {} {} {} {}", st.begin_cycles, st.widget_cycles,
+              st.end_cycles, ps.flush_cycles);
+
+    i16 tw = 0;
+    u32 h = 0;
+    for (usize i = 0; i < lines; ++i) {
+      tw = std::max(tw, draw::text_width(p_, text[i], 1));
+      h = mix_id(h, hash_label(text[i]));
+    }
+    i16 lh = static_cast<i16>(draw::text_height(p_, 1) + 1);
+    i16 bw = static_cast<i16>(tw + 4);
+    i16 bh = static_cast<i16>(lh * lines + 3);
+    rect r = {{static_cast<i16>(p_.width() - bw - 2), 2},
+              {static_cast<u16>(bw), static_cast<u16>(bh)}};
+    if (!paint(0x57A, r, h)) return;
+    p_.fill_rect(r.x(), r.y(), bw, bh, theme_.bg);
+    draw::rounded_rect_outline(p_, r, 0, theme_.border);
+    for (usize i = 0; i < lines; ++i) {
+      p_.set_cursor(static_cast<i16>(r.x() + 2),
+                    static_cast<i16>(r.y() + 2 + lh * static_cast<i16>(i)));
+      p_.set_text_color(theme_.text);
+      p_.set_text_size(1);
+      p_.print(text[i]);
+    }
+  }
+#endif
+
+  void push_clip(rect r) {
+    if (clip_depth_ < max_clip_depth) {
+      rect c = current_clip().intersect(r);
+      clip_stack_[clip_depth_] = c;
+      if (painting_) p_.set_clip(c);
+    }
+    ++clip_depth_;
+  }
+
+  void pop_clip() {
+    if (clip_depth_ == 0) return;
+    if (--clip_depth_ >= max_clip_depth) return;
+    if (!painting_) return;
+    if (clip_depth_ > 0)
+      p_.set_clip(clip_stack_[clip_depth_ - 1]);
+    else
+      p_.clear_clip();
+  }
+
+  rect current_clip() const {
+    usize n = std::min(clip_depth_, max_clip_depth);
+    if (n > 0) return clip_stack_[n - 1];
+    return {{0, 0}, {p_.width(), p_.height()}};
+  }
+
+  bool visible(rect r) const {
+    return !layout_.top().culled && current_clip().overlaps(r);
   }
 
   anim_pool& anims() { return anims_; }
@@ -71,6 +223,7 @@ class ctx {
         .cursor = r.pos,
         .dir = direction::horizontal,
         .spacing = s(theme_.spacing),
+        .culled = !visible(r),
     });
   }
 
@@ -83,6 +236,7 @@ class ctx {
         .cursor = r.pos,
         .dir = direction::vertical,
         .spacing = s(theme_.spacing),
+        .culled = !visible(r),
     });
   }
 
@@ -115,43 +269,50 @@ class ctx {
 
   void label(const char* text) {
     u8 fs = font_size();
-    i16 tw = draw::text_width(text, fs);
-    i16 th = draw::text_height(fs);
-    i16 wh = std::max(th, s(theme_.widget_height));
+    text_metrics m = measure(text, fs);
+    i16 wh = std::max(m.h, s(theme_.widget_height));
     rect r = layout_.allocate(static_cast<u16>(std::min<i16>(
-                                  tw + s(theme_.padding) * 2,
+                                  m.w + s(theme_.padding) * 2,
                                   static_cast<i16>(layout_.available_w()))),
                               static_cast<u16>(wh));
+    if (!paint(0x1AB, r, theme_.text, m.hash)) return;
     draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
   }
 
   void label_colored(const char* text, u16 color) {
     u8 fs = font_size();
-    i16 tw = draw::text_width(text, fs);
-    i16 th = draw::text_height(fs);
-    i16 wh = std::max(th, s(theme_.widget_height));
+    text_metrics m = measure(text, fs);
+    i16 wh = std::max(m.h, s(theme_.widget_height));
     rect r = layout_.allocate(static_cast<u16>(std::min<i16>(
-                                  tw + s(theme_.padding) * 2,
+                                  m.w + s(theme_.padding) * 2,
                                   static_cast<i16>(layout_.available_w()))),
                               static_cast<u16>(wh));
+    if (!paint(0x1AB, r, color, m.hash)) return;
     draw::text_left(p_, r, text, color, fs, s(theme_.padding));
   }
 
-  void label_fmt(const char* fmt, ...) {
+  template <formattable... Args>
+  void label_fmt(format_string<std::type_identity_t<Args>...> fmt,
+                 const Args&... args) {
     char buf[128];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
+    format_to(buf, fmt, args...);
     label(buf);
   }
 
+  template <formattable... Args>
+  void label_fmt(u16 color, format_string<std::type_identity_t<Args>...> fmt,
+                 const Args&... args) {
+    char buf[128];
+    format_to(buf, fmt, args...);
+    label_colored(buf, color);
+  }
+
   bool button(const char* text) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
-    i16 tw = draw::text_width(text, fs);
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
-    i16 w = static_cast<i16>(tw + s(theme_.padding) * 4);
+    i16 w = static_cast<i16>(m.w + s(theme_.padding) * 4);
     if (layout_.top().dir == direction::horizontal)
       w = std::min(w, static_cast<i16>(layout_.available_w()));
     rect r = layout_.allocate(static_cast<u16>(w), static_cast<u16>(h));
@@ -173,19 +334,20 @@ class ctx {
     else if (hot_ == wid)
       bg_color = theme_.accent_hover;
 
+    if (!paint(wid, r, bg_color, m.hash)) return pressed;
     u16 top_c = lighten(bg_color, 60);
     u16 bot_c = darken(bg_color, 40);
-    draw::rounded_rect_gradient_v(p_, r, s(theme_.corner_radius), top_c, bot_c);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    gradient_round(r, s(theme_.corner_radius), top_c, bot_c);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
     return pressed;
   }
 
   bool button_colored(const char* text, u16 color) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
-    i16 tw = draw::text_width(text, fs);
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
-    i16 w = static_cast<i16>(tw + s(theme_.padding) * 4);
+    i16 w = static_cast<i16>(m.w + s(theme_.padding) * 4);
     if (layout_.top().dir == direction::horizontal)
       w = std::min(w, static_cast<i16>(layout_.available_w()));
     rect r = layout_.allocate(static_cast<u16>(w), static_cast<u16>(h));
@@ -207,18 +369,20 @@ class ctx {
     else if (hot_ == wid)
       bg = lighten(color, 50);
 
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius), bg);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    if (!paint(wid, r, bg, m.hash)) return pressed;
+    fill_round(r, s(theme_.corner_radius), bg);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
     return pressed;
   }
 
   bool toggle(const char* text, bool& value) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     i16 track_w = s(28);
     i16 track_h = s(14);
-    i16 tw = draw::text_width(text, fs);
+    i16 tw = m.w;
     i16 total_w = static_cast<i16>(tw + track_w + s(theme_.padding) * 3);
     rect r = layout_.allocate(static_cast<u16>(total_w), static_cast<u16>(h));
 
@@ -233,6 +397,11 @@ class ctx {
     }
     if (input_.down_in(r)) hot_ = wid;
 
+    id anim_id = mix_id(wid, 0xA1);
+    anims_.ensure(anim_id, value ? 256 : 0, 180, ease::out_cubic);
+    i32 frac = anims_.get(anim_id, value ? 256 : 0);
+    if (!paint(wid, r, static_cast<u32>(frac), m.hash)) return toggled;
+
     draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
 
     i16 track_x = static_cast<i16>(r.x() + tw + s(theme_.padding) * 2);
@@ -241,13 +410,9 @@ class ctx {
                     {static_cast<u16>(track_w), static_cast<u16>(track_h)}};
     i16 track_radius = static_cast<i16>(track_h / 2);
 
-    id anim_id = mix_id(wid, 0xA1);
-    anims_.ensure(anim_id, value ? 256 : 0, 180, ease::out_cubic);
-    i32 frac = anims_.get(anim_id, value ? 256 : 0);
-
     u16 track_color = blend_rgb565(theme_.accent, theme_.surface_alt,
                                    static_cast<u8>(frac > 255 ? 255 : frac));
-    draw::rounded_rect_fill(p_, track_r, track_radius, track_color);
+    fill_round(track_r, track_radius, track_color);
     draw::rounded_rect_outline(p_, track_r, track_radius, theme_.border);
 
     i16 off_x = static_cast<i16>(track_x + track_h / 2);
@@ -255,17 +420,18 @@ class ctx {
     i16 knob_x = static_cast<i16>(off_x + ((on_x - off_x) * frac >> 8));
     i16 knob_y = static_cast<i16>(track_y + track_h / 2);
     i16 knob_r = static_cast<i16>(track_h / 2 - 2);
-    p_.fill_circle(knob_x, knob_y, knob_r, theme_.text);
+    fill_disc(knob_x, knob_y, knob_r, theme_.text);
 
     return toggled;
   }
 
   bool checkbox(const char* text, bool& value) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     i16 box_sz = s(14);
-    i16 tw = draw::text_width(text, fs);
+    i16 tw = m.w;
     i16 total_w = static_cast<i16>(box_sz + tw + s(theme_.padding) * 3);
     rect r = layout_.allocate(static_cast<u16>(total_w), static_cast<u16>(h));
 
@@ -288,10 +454,11 @@ class ctx {
     id anim_id = mix_id(wid, 0xCB);
     anims_.ensure(anim_id, value ? 256 : 0, 150, ease::out_cubic);
     i32 frac = anims_.get(anim_id, value ? 256 : 0);
+    if (!paint(wid, r, static_cast<u32>(frac), m.hash)) return toggled;
 
     u16 box_bg = blend_rgb565(theme_.accent, theme_.surface_alt,
                               static_cast<u8>(frac > 255 ? 255 : frac));
-    draw::rounded_rect_fill(p_, box_r, s(2), box_bg);
+    fill_round(box_r, s(2), box_bg);
     draw::rounded_rect_outline(p_, box_r, s(2), theme_.border);
 
     if (frac > 32) {
@@ -314,11 +481,12 @@ class ctx {
   }
 
   bool radio(const char* text, i16& current_val, i16 this_val) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     i16 circle_r = s(6);
-    i16 tw = draw::text_width(text, fs);
+    i16 tw = m.w;
     i16 total_w = static_cast<i16>(circle_r * 2 + tw + s(theme_.padding) * 3);
     rect r = layout_.allocate(static_cast<u16>(total_w), static_cast<u16>(h));
 
@@ -337,16 +505,17 @@ class ctx {
     i16 cx = static_cast<i16>(r.x() + s(theme_.padding) + circle_r);
     i16 cy = static_cast<i16>(r.y() + h / 2);
 
-    draw::circle_outline(p_, cx, cy, circle_r, theme_.border);
-
     id anim_id = mix_id(wid, 0xD1);
     anims_.ensure(anim_id, selected ? 256 : 0, 150, ease::out_cubic);
     i32 frac = anims_.get(anim_id, selected ? 256 : 0);
+    if (!paint(wid, r, static_cast<u32>(frac), m.hash)) return changed;
+
+    ring(cx, cy, circle_r, theme_.border);
 
     if (frac > 32) {
       i16 inner_r = static_cast<i16>((circle_r - 3) * frac / 256);
       if (inner_r < 1) inner_r = 1;
-      p_.fill_circle(cx, cy, inner_r, theme_.accent);
+      fill_disc(cx, cy, inner_r, theme_.accent);
     }
 
     rect text_r = {{static_cast<i16>(cx + circle_r + s(theme_.padding)), r.y()},
@@ -356,14 +525,14 @@ class ctx {
   }
 
   bool slider(const char* text, i16& value, i16 min_val, i16 max_val) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     u16 full_w = layout_.available_w();
     rect r = layout_.allocate(full_w, static_cast<u16>(h));
 
-    i16 tw = draw::text_width(text, fs);
-    i16 label_w = static_cast<i16>(tw + s(theme_.padding) * 2);
+    i16 label_w = static_cast<i16>(m.w + s(theme_.padding) * 2);
     i16 track_x = static_cast<i16>(r.x() + label_w);
     i16 track_w =
         static_cast<i16>(static_cast<i16>(r.w()) - label_w - s(theme_.padding));
@@ -389,9 +558,6 @@ class ctx {
     }
     if (input_.down_in(r)) hot_ = wid;
 
-    draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
-    draw::rounded_rect_fill(p_, track_r, s(3), theme_.surface_alt);
-
     i32 range = max_val - min_val;
     i32 target_fill =
         range > 0 ? static_cast<i32>(value - min_val) * track_w / range : 0;
@@ -403,28 +569,36 @@ class ctx {
     i32 fill_w =
         std::clamp<i32>(anims_.get(fill_anim, target_fill), 0, track_w);
 
+    id halo_anim = mix_id(wid, 0xF2);
+    anims_.ensure(halo_anim, (active_ == wid) ? 256 : 0, 150, ease::out_quad);
+    i32 halo_frac = anims_.get(halo_anim, 0);
+
+    u32 pressed_bit = active_ == wid ? 1u << 16 : 0;
+    u32 state = mix_id(static_cast<u32>(fill_w),
+                       static_cast<u32>(halo_frac) | pressed_bit);
+    if (!paint(wid, r, state, m.hash)) return changed;
+
+    draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
+    fill_round(track_r, s(3), theme_.surface_alt);
+
     if (fill_w > 0) {
       rect fill_r = {{track_x, track_y},
                      {static_cast<u16>(fill_w), static_cast<u16>(track_h)}};
-      draw::rounded_rect_fill(p_, fill_r, s(3), theme_.accent);
+      fill_round(fill_r, s(3), theme_.accent);
     }
 
     i16 thumb_x = static_cast<i16>(track_x + fill_w);
     i16 thumb_y = static_cast<i16>(r.y() + h / 2);
     i16 thumb_r = s(5);
 
-    id halo_anim = mix_id(wid, 0xF2);
-    anims_.ensure(halo_anim, (active_ == wid) ? 256 : 0, 150, ease::out_quad);
-    i32 halo_frac = anims_.get(halo_anim, 0);
     if (halo_frac > 16) {
       i16 halo_r = static_cast<i16>(thumb_r + s(3) * halo_frac / 256);
       u8 halo_a = static_cast<u8>(80 * halo_frac / 256);
-      u16 halo_c = blend_rgb565(theme_.accent, theme_.bg, halo_a);
-      p_.fill_circle(thumb_x, thumb_y, halo_r, halo_c);
+      fill_disc_blend(thumb_x, thumb_y, halo_r, theme_.accent, halo_a);
     }
 
     u16 thumb_c = (active_ == wid) ? theme_.accent_press : theme_.accent;
-    p_.fill_circle(thumb_x, thumb_y, thumb_r, thumb_c);
+    fill_disc(thumb_x, thumb_y, thumb_r, thumb_c);
     return changed;
   }
 
@@ -434,8 +608,8 @@ class ctx {
     u16 full_w = layout_.available_w();
     rect r = layout_.allocate(full_w, static_cast<u16>(h));
 
-    i16 tw = draw::text_width(text, fs);
-    i16 label_w = static_cast<i16>(tw + s(theme_.padding) * 2);
+    text_metrics m = measure(text, fs);
+    i16 label_w = static_cast<i16>(m.w + s(theme_.padding) * 2);
     i16 bar_x = static_cast<i16>(r.x() + label_w);
     i16 bar_w =
         static_cast<i16>(static_cast<i16>(r.w()) - label_w - s(theme_.padding));
@@ -444,15 +618,17 @@ class ctx {
     rect bar_r = {{bar_x, bar_y},
                   {static_cast<u16>(bar_w), static_cast<u16>(bar_h)}};
 
-    draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
-    draw::rounded_rect_fill(p_, bar_r, s(3), theme_.surface_alt);
-
     float f = std::clamp(fraction, 0.0f, 1.0f);
     i16 fill_w = static_cast<i16>(static_cast<float>(bar_w) * f);
+    if (!paint(0x960, r, static_cast<u32>(fill_w), m.hash)) return;
+
+    draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
+    fill_round(bar_r, s(3), theme_.surface_alt);
+
     if (fill_w > 0) {
       rect fill_r = {{bar_x, bar_y},
                      {static_cast<u16>(fill_w), static_cast<u16>(bar_h)}};
-      draw::rounded_rect_fill(p_, fill_r, s(3), theme_.accent);
+      fill_round(fill_r, s(3), theme_.accent);
     }
   }
 
@@ -460,30 +636,96 @@ class ctx {
              u16 fill_color, u16 track_color) {
     i16 start_deg = 135;
     i16 end_deg = 45;
-    draw::arc_fill(p_, cx, cy, outer_r, inner_r, start_deg, end_deg,
-                   track_color);
-
     float f = std::clamp(fraction, 0.0f, 1.0f);
     i16 sweep = 270;
     i16 fill_end = static_cast<i16>(
         start_deg + static_cast<i16>(static_cast<float>(sweep) * f));
     if (fill_end >= 360) fill_end = static_cast<i16>(fill_end - 360);
+
+    u16 d = static_cast<u16>(2 * outer_r + 1);
+    rect r = {{static_cast<i16>(cx - outer_r), static_cast<i16>(cy - outer_r)},
+              {d, d}};
+    u32 radii = (static_cast<u32>(static_cast<u16>(outer_r)) << 16) |
+                static_cast<u16>(inner_r);
+    u32 state = mix_id((static_cast<u32>(fill_color) << 16) | track_color,
+                       static_cast<u32>(f > 0.001f ? fill_end : -1));
+    state = mix_id(state, radii);
+    if (!paint(0x6A0, r, state)) return;
+
+    fill_arc(cx, cy, outer_r, inner_r, start_deg, end_deg, track_color);
     if (f > 0.001f)
-      draw::arc_fill(p_, cx, cy, outer_r, inner_r, start_deg, fill_end,
-                     fill_color);
+      fill_arc(cx, cy, outer_r, inner_r, start_deg, fill_end, fill_color);
+  }
+
+  void plot(const char* name, const series& data, i16 lo, i16 hi,
+            u16 per_col = 0, i16 height = 0) {
+    id pid = ids_.make(name);
+    i16 h = height > 0 ? s(height)
+                       : static_cast<i16>(2 * s(theme_.widget_height));
+    rect r = layout_.allocate(layout_.available_w(), static_cast<u16>(h));
+    auto_range(data, lo, hi);
+    u32 range = (static_cast<u32>(static_cast<u16>(lo)) << 16) |
+                static_cast<u16>(hi);
+    u32 column = per_col ? draw::strip_column(data, per_col) : 0;
+    plot_entry* e = nullptr;
+    if constexpr (scroll_painter<P>) {
+      if (per_col) e = plots_.get(pid);
+    }
+    plot_entry last = e ? *e : plot_entry{};
+    if (!paint(0x910, r, mix_id(mix_id(data.total, range), per_col))) return;
+
+    u16 bg = theme_.surface_alt;
+    if (per_col == 0) {
+      draw::plot_fit(p_, r, data, lo, hi, theme_.accent, bg);
+      return;
+    }
+    i16 w = static_cast<i16>(r.w());
+    i16 from = 0;
+    u32 shift = column - last.column;
+    if (last.drawn && last.r == r && last.range == range &&
+        last.per_col == per_col && data.total >= last.total && shift < r.w()) {
+      if constexpr (scroll_painter<P>) {
+        if (shift) p_.scroll_region(r, static_cast<i16>(-shift), 0);
+      }
+      from = static_cast<i16>(w - 1 - shift);
+      for (usize i = 0; i < last.damaged; ++i) {
+        rect d = last.damage[i];
+        d.pos.x = static_cast<i16>(d.x() - shift);
+        d = d.intersect(r);
+        if (d.w() == 0) continue;
+        push_clip(d);
+        draw::plot_strip(p_, r, data, per_col, lo, hi, theme_.accent, bg,
+                         static_cast<i16>(d.x() - r.x()),
+                         static_cast<i16>(d.right() - r.x()));
+        pop_clip();
+      }
+    }
+    draw::plot_strip(p_, r, data, per_col, lo, hi, theme_.accent, bg, from, w);
+    if (e) *e = {r, range, per_col, data.total, column, true};
+  }
+
+  void sparkline(const series& data, i16 lo, i16 hi, i16 width = 0) {
+    i16 w = width > 0 ? s(width) : s(60);
+    i16 h = s(theme_.widget_height);
+    rect r = layout_.allocate(static_cast<u16>(w), static_cast<u16>(h));
+    auto_range(data, lo, hi);
+    u32 range = (static_cast<u32>(static_cast<u16>(lo)) << 16) |
+                static_cast<u16>(hi);
+    if (!paint(0x5A4, r, mix_id(data.total, range))) return;
+    draw::plot_fit(p_, r, data, lo, hi, theme_.accent, theme_.surface_alt);
   }
 
   void badge(const char* text, u16 color) {
     u8 fs = font_size();
-    i16 tw = draw::text_width(text, fs);
-    i16 th = draw::text_height(fs);
+    text_metrics m = measure(text, fs);
     i16 pad_h = s(2);
     i16 pad_w = s(6);
-    i16 bw = static_cast<i16>(tw + pad_w * 2);
-    i16 bh = static_cast<i16>(th + pad_h * 2);
+    i16 bw = static_cast<i16>(m.w + pad_w * 2);
+    i16 bh = static_cast<i16>(m.h + pad_h * 2);
     rect r = layout_.allocate(static_cast<u16>(bw), static_cast<u16>(bh));
-    draw::rounded_rect_fill(p_, r, static_cast<i16>(bh / 2), color);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    if (!paint(0xBAD, r, color, m.hash)) return;
+    fill_round(r, static_cast<i16>(bh / 2), color);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
   }
 
   void header(const char* text, u16 bg_color = 0) {
@@ -492,13 +734,16 @@ class ctx {
     u16 full_w = layout_.available_w();
     rect r = layout_.allocate(full_w, static_cast<u16>(h));
     u16 bg = bg_color != 0 ? bg_color : theme_.accent;
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius), bg);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    text_metrics m = measure(text, fs);
+    if (!paint(0x4EA, r, bg, m.hash)) return;
+    fill_round(r, s(theme_.corner_radius), bg);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
   }
 
   bool tile(const char* text, u16 color, u16 tile_w, u16 tile_h) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     rect r = layout_.allocate(tile_w, tile_h);
 
     bool hovered = input_.down_in(r);
@@ -518,22 +763,26 @@ class ctx {
     else if (hot_ == wid)
       bg = lighten(color, 40);
 
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius + 2), bg);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    if (!paint(wid, r, bg, m.hash)) return pressed;
+    fill_round(r, s(theme_.corner_radius + 2), bg);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
     return pressed;
   }
 
   void stat_card(const char* label, const char* value, u16 accent_color) {
     u8 fs = font_size();
     u8 vfs = static_cast<u8>(fs < 2 ? 2 : fs);
-    i16 lh = draw::text_height(fs);
-    i16 vh = draw::text_height(vfs);
+    i16 lh = draw::text_height(p_, fs);
+    i16 vh = draw::text_height(p_, vfs);
     i16 pad = s(theme_.padding);
     i16 h = static_cast<i16>(lh + vh + pad * 2 + s(2));
     u16 w = layout_.available_w();
     rect r = layout_.allocate(w, static_cast<u16>(h));
 
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius), theme_.surface_alt);
+    u32 state = mix_id(hash_label(value), accent_color);
+    if (!paint(0x5CA, r, state, label)) return;
+
+    fill_round(r, s(theme_.corner_radius), theme_.surface_alt);
 
     i16 bar_w = s(3);
     p_.fill_rect(r.x(), static_cast<i16>(r.y() + s(2)), bar_w,
@@ -552,7 +801,8 @@ class ctx {
   }
 
   bool list_item(const char* text, bool selected) {
-    id wid = ids_.make(text);
+    id text_hash = hash_label(text);
+    id wid = ids_.make(text_hash);
     u8 fs = font_size();
     i16 h = s(theme_.widget_height);
     u16 full_w = layout_.available_w();
@@ -568,21 +818,22 @@ class ctx {
 
     u16 bg = selected ? theme_.accent
                       : (hot_ == wid ? theme_.surface_alt : theme_.surface);
-    draw::rounded_rect_fill(p_, r, s(2), bg);
+    if (!paint(wid, r, bg, text_hash)) return pressed;
+    fill_round(r, s(2), bg);
     draw::text_left(p_, r, text, theme_.text, fs, s(theme_.padding));
     return pressed;
   }
 
   bool spinner(const char* label, i16& value, i16 min_val, i16 max_val,
                i16 step = 1) {
-    id wid = ids_.make(label);
     u8 fs = font_size();
+    text_metrics m = measure(label, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     u16 full_w = layout_.available_w();
     rect r = layout_.allocate(full_w, static_cast<u16>(h));
 
-    i16 tw = draw::text_width(label, fs);
-    i16 label_w = static_cast<i16>(tw + s(theme_.padding) * 2);
+    i16 label_w = static_cast<i16>(m.w + s(theme_.padding) * 2);
     i16 btn_w = h;
 
     rect minus_r = {{static_cast<i16>(r.x() + label_w), r.y()},
@@ -617,30 +868,35 @@ class ctx {
       active_ = 0;
     }
 
-    draw::text_left(p_, r, label, theme_.text, fs, s(theme_.padding));
-
     u16 minus_bg =
         (active_ == minus_id) ? theme_.accent_press : theme_.surface_alt;
-    draw::rounded_rect_fill(p_, minus_r, s(2), minus_bg);
-    draw::text_centered(p_, minus_r, "-", theme_.text, fs);
-
     u16 plus_bg =
         (active_ == plus_id) ? theme_.accent_press : theme_.surface_alt;
-    draw::rounded_rect_fill(p_, plus_r, s(2), plus_bg);
+    u32 state = mix_id(static_cast<u32>(static_cast<u16>(value)),
+                       (static_cast<u32>(minus_bg) << 16) | plus_bg);
+    if (!paint(wid, r, state, m.hash)) return changed;
+
+    draw::text_left(p_, r, label, theme_.text, fs, s(theme_.padding));
+
+    fill_round(minus_r, s(2), minus_bg);
+    draw::text_centered(p_, minus_r, "-", theme_.text, fs);
+
+    fill_round(plus_r, s(2), plus_bg);
     draw::text_centered(p_, plus_r, "+", theme_.text, fs);
 
-    draw::rounded_rect_fill(p_, val_r, 0, theme_.surface);
+    fill_round(val_r, 0, theme_.surface);
     draw::rounded_rect_outline(p_, val_r, 0, theme_.border);
     char vbuf[16];
-    snprintf(vbuf, sizeof(vbuf), "%d", value);
+    format_to(vbuf, "{}", value);
     draw::text_centered(p_, val_r, vbuf, theme_.text, fs);
 
     return changed;
   }
 
   bool button_fill(const char* text) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     u16 w = layout_.available_w();
     rect r = layout_.allocate(w, static_cast<u16>(h));
@@ -662,16 +918,18 @@ class ctx {
     else if (hot_ == wid)
       bg_color = theme_.accent_hover;
 
+    if (!paint(wid, r, bg_color, m.hash)) return pressed;
     u16 top_c = lighten(bg_color, 60);
     u16 bot_c = darken(bg_color, 40);
-    draw::rounded_rect_gradient_v(p_, r, s(theme_.corner_radius), top_c, bot_c);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    gradient_round(r, s(theme_.corner_radius), top_c, bot_c);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
     return pressed;
   }
 
   bool button_fill_colored(const char* text, u16 color) {
-    id wid = ids_.make(text);
     u8 fs = font_size();
+    text_metrics m = measure(text, fs);
+    id wid = ids_.make(m.hash);
     i16 h = s(theme_.widget_height);
     u16 w = layout_.available_w();
     rect r = layout_.allocate(w, static_cast<u16>(h));
@@ -693,8 +951,9 @@ class ctx {
     else if (hot_ == wid)
       bg = lighten(color, 50);
 
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius), bg);
-    draw::text_centered(p_, r, text, theme_.text, fs);
+    if (!paint(wid, r, bg, m.hash)) return pressed;
+    fill_round(r, s(theme_.corner_radius), bg);
+    draw::text_centered(p_, r, text, theme_.text, fs, m.w, m.h);
     return pressed;
   }
 
@@ -703,7 +962,8 @@ class ctx {
     layout_.advance(sp);
     u16 w = layout_.available_w();
     rect r = layout_.allocate(w, 1);
-    p_.hline(r.x(), r.y(), static_cast<i16>(r.w()), theme_.border);
+    if (paint(0x5E9, r, theme_.border))
+      p_.hline(r.x(), r.y(), static_cast<i16>(r.w()), theme_.border);
     layout_.advance(sp);
   }
 
@@ -712,115 +972,206 @@ class ctx {
     u16 w = layout_.available_w();
     u16 h = layout_.available_h();
     rect r = layout_.allocate(w, h);
-
-    if (with_shadow) {
-      draw::shadow(p_, r, s(theme_.corner_radius), theme_.bg, 3, s(2), s(2));
-    }
-
-    draw::rounded_rect_fill(p_, r, s(theme_.corner_radius), theme_.surface);
-    draw::rounded_rect_outline(p_, r, s(theme_.corner_radius), theme_.border);
-
     rect inner = r.shrink(pad_val);
+    i16 title_h = 0;
 
     if (title) {
-      u8 fs = font_size();
-      i16 th = draw::text_height(fs);
-      i16 title_h = static_cast<i16>(th + pad_val);
-      rect title_r = {inner.pos, {inner.w(), static_cast<u16>(title_h)}};
-      draw::text_left(p_, title_r, title, theme_.text, fs, 0);
-      p_.hline(inner.x(), static_cast<i16>(inner.y() + title_h),
-               static_cast<i16>(inner.w()), theme_.border);
+      title_h = static_cast<i16>(draw::text_height(p_, font_size()) + pad_val);
       inner.pos.y = static_cast<i16>(inner.y() + title_h + pad_val);
       inner.size.h = static_cast<u16>(
           inner.h() > title_h + pad_val ? inner.h() - title_h - pad_val : 0);
     }
 
     id pid = title ? ids_.make(title) : ids_.make("__panel__");
-    i16 si = find_scroll(pid);
-
-    active_panel_.scroll_idx = si;
-    active_panel_.clip = inner;
-    active_panel_.content_start_y = inner.y();
+    scroll_entry* se = scroll_.get(pid);
 
     rect content_bounds = inner;
-    if (si >= 0 && scroll_[si].content_h > static_cast<i16>(inner.h())) {
+    if (se && se->content_h > static_cast<i16>(inner.h())) {
       i16 bar_space = static_cast<i16>(s(4) + s(2));
       content_bounds.size.w = static_cast<u16>(
           inner.w() > bar_space ? inner.w() - bar_space : inner.w());
     }
+    rect view = {content_bounds.pos, {content_bounds.w(), inner.h()}};
+    rect area = view;
+    if (layout_.depth == 1 && r.x() <= root_edge() &&
+        r.right() >= p_.width() - root_edge())
+      area = {{0, view.y()}, {p_.width(), view.h()}};
+    rect band = se ? scroll_band(*se, r, view, area) : view;
+    bool banded = band != view;
+
+    bool drawn = paint(0x9A1, r, with_shadow, title);
+    if (drawn) {
+      if (with_shadow) {
+        draw::shadow(p_, r, s(theme_.corner_radius), theme_.bg, s(3), s(2),
+                     s(2));
+      }
+      if (!banded) {
+        panel_chrome(r, title, title_h);
+      } else {
+        i16 edge_x = static_cast<i16>(r.right() - 1);
+        p_.fill_rect(view.right(), inner.y(),
+                     static_cast<i16>(edge_x - view.right()),
+                     static_cast<i16>(inner.h()), theme_.surface);
+        p_.vline(edge_x, inner.y(), static_cast<i16>(inner.h()),
+                 theme_.border);
+        p_.fill_rect(band.x(), band.y(), static_cast<i16>(band.w()),
+                     static_cast<i16>(band.h()), theme_.surface);
+      }
+    }
+
+    active_panel_ = {};
+    active_panel_.scroll = se;
+    active_panel_.clip = inner;
+    active_panel_.frame = r;
+    active_panel_.view = view;
+    active_panel_.content_start_y = inner.y();
+    active_panel_.offset = se ? se->offset : 0;
+    active_panel_.drawn = drawn;
+    active_panel_.banded = banded;
     content_bounds.size.h = 4096;
 
     vec2 cursor = content_bounds.pos;
-    if (si >= 0) cursor.y = static_cast<i16>(cursor.y - scroll_[si].offset);
+    if (se) cursor.y = static_cast<i16>(cursor.y - se->offset);
 
-    p_.set_clip(inner);
+    bool culled = !visible(inner);
+    push_clip(inner);
+    if (banded) push_clip(band);
     layout_.push({
         .bounds = content_bounds,
         .cursor = cursor,
         .dir = direction::vertical,
         .spacing = s(theme_.spacing),
+        .culled = culled,
     });
   }
 
   void panel_end() {
-    i16 si = active_panel_.scroll_idx;
-    if (si >= 0) {
-      auto& se = scroll_[si];
+    if (active_panel_.banded) pop_clip();
+    if (active_panel_.scroll) {
+      auto& se = *active_panel_.scroll;
       auto& c = layout_.top();
-      i16 content_h = static_cast<i16>(
-          c.cursor.y - (active_panel_.content_start_y - se.offset));
-      se.content_h = content_h;
-
-      i16 visible_h = static_cast<i16>(active_panel_.clip.h());
-      i16 max_scroll = content_h > visible_h
-                           ? static_cast<i16>(content_h - visible_h)
-                           : static_cast<i16>(0);
-
-      if (active_ == 0 && input_.held()) {
-        if (active_panel_.clip.contains(input_.pos()) ||
-            active_panel_.clip.contains(input_.prev_pos())) {
-          i16 dy = static_cast<i16>(input_.pos().y - input_.prev_pos().y);
-          se.offset = static_cast<i16>(se.offset - dy);
-          se.velocity = static_cast<i16>(-dy * 4);
-        }
-      } else if (!input_.down() && se.velocity != 0) {
-        se.offset = static_cast<i16>(se.offset + se.velocity / 4);
-        if (se.velocity > 0)
-          se.velocity = static_cast<i16>(se.velocity - 1);
-        else if (se.velocity < 0)
-          se.velocity = static_cast<i16>(se.velocity + 1);
+      se.content_h = c.cursor.y - (active_panel_.content_start_y - se.offset);
+      active_panel_.scroll = nullptr;
+      scroll_drag(se, active_panel_.clip);
+      scrollbar(active_panel_.clip, se);
+      if (painting_) {
+        se.drawn = active_panel_.drawn &&
+                   (!active_panel_.banded || active_panel_.hash == se.hash);
+        se.drawn_offset = active_panel_.offset;
+        se.frame = active_panel_.frame;
+        se.view = active_panel_.view;
+        se.hash = active_panel_.hash;
+      } else if (active_panel_.hash != se.hash) {
+        se.drawn = false;
       }
+    }
+    pop_clip();
+    end();
+  }
 
-      if (se.offset < 0) se.offset = 0;
-      if (se.offset > max_scroll) se.offset = max_scroll;
-
-      if (max_scroll > 0) {
-        i16 bar_w = s(3);
-        i16 bar_x = static_cast<i16>(active_panel_.clip.right() - bar_w);
-        i16 bar_h = static_cast<i16>(active_panel_.clip.h());
-        i16 thumb_h =
-            static_cast<i16>(static_cast<i32>(bar_h) * visible_h / content_h);
-        if (thumb_h < s(8)) thumb_h = s(8);
-        i16 thumb_y = static_cast<i16>(active_panel_.clip.y() +
-                                       static_cast<i32>(se.offset) *
-                                           (bar_h - thumb_h) / max_scroll);
-        p_.fill_rect(bar_x, active_panel_.clip.y(), bar_w, bar_h,
-                     theme_.surface_alt);
-        draw::rounded_rect_fill(
-            p_,
-            rect{{bar_x, thumb_y},
-                 {static_cast<u16>(bar_w), static_cast<u16>(thumb_h)}},
-            static_cast<i16>(bar_w / 2), theme_.border);
+  class list_range {
+   public:
+    class iterator {
+     public:
+      u32 operator*() const { return i_; }
+      iterator& operator++() {
+        open(i_ + 1);
+        return *this;
       }
+      bool operator!=(const iterator& o) const { return i_ != o.i_; }
 
-      p_.clear_clip();
-      active_panel_.scroll_idx = -1;
+     private:
+      friend class list_range;
+      iterator(ctx* ui, u32 i, u32 last) : ui_{ui}, i_{i}, last_{last} {}
+
+      void open(u32 i) {
+        i_ = i;
+        if (i_ != last_) ui_->list_row(i_);
+      }
+
+      ctx* ui_;
+      u32 i_;
+      u32 last_;
+    };
+
+    iterator begin() const {
+      iterator it{ui_, first_, last_};
+      it.open(first_);
+      return it;
+    }
+    iterator end() const { return {ui_, last_, last_}; }
+    u32 first() const { return first_; }
+    u32 last() const { return last_; }
+
+   private:
+    friend class ctx;
+    list_range(ctx* ui, u32 first, u32 last)
+        : ui_{ui}, first_{first}, last_{last} {}
+
+    ctx* ui_;
+    u32 first_;
+    u32 last_;
+  };
+
+  list_range list_begin(const char* name, u32 count, i16 row_h = 0,
+                        i16 height = 0) {
+    return begin_list(name, nullptr, 0, count, row_h, height);
+  }
+
+  void list_end() {
+    if (!list_.open) return;
+    if (list_.row_open) {
+      end();
+      pop_id();
     }
     end();
+    pop_id();
+    if (list_.scroll) scrollbar(list_.body, *list_.scroll);
+    pop_clip();
+    list_.open = false;
+  }
+
+  list_range table_begin(const char* name, const table_column* columns,
+                         usize column_count, u32 count, i16 row_h = 0,
+                         i16 height = 0) {
+    return begin_list(name, columns, column_count, count, row_h, height);
+  }
+
+  template <usize N>
+  list_range table_begin(const char* name, const table_column (&columns)[N],
+                         u32 count, i16 row_h = 0, i16 height = 0) {
+    return begin_list(name, columns, N, count, row_h, height);
+  }
+
+  void table_end() { list_end(); }
+
+  void table_cell(const char* text, u16 color) {
+    if (!list_.row_open || list_.col >= list_.column_count) return;
+    const table_column& col = list_.columns[list_.col++];
+    rect r = layout_.allocate(column_width(col, layout_.available_w()),
+                              static_cast<u16>(list_.row_h));
+    u8 fs = font_size();
+    id text_hash = hash_label(text);
+    if (!paint(0x7C1, r, color, text_hash)) return;
+    push_clip(r);
+    draw::text_left(p_, r, text, color, fs, s(theme_.padding));
+    pop_clip();
+  }
+
+  void table_cell(const char* text) { table_cell(text, theme_.text); }
+
+  template <formattable... Args>
+  void table_cell_fmt(format_string<std::type_identity_t<Args>...> fmt,
+                      const Args&... args) {
+    char buf[64];
+    format_to(buf, fmt, args...);
+    table_cell(buf);
   }
 
   void icon(const u16* bitmap, u16 w, u16 h) {
     rect r = layout_.allocate(w, h);
+    if (!paint(0x1C0, r, static_cast<u32>(reinterpret_cast<uintptr_t>(bitmap))))
+      return;
     for (i16 row = 0; row < static_cast<i16>(h); ++row) {
       for (i16 col = 0; col < static_cast<i16>(w); ++col) {
         u16 px = bitmap[row * w + col];
@@ -853,37 +1204,469 @@ class ctx {
 
   i16 s(i16 value) const { return scale(value, scale_); }
 
+  void fill_round(rect r, i16 radius, u16 color) {
+    if (theme_.antialias)
+      draw::rounded_rect_fill_aa(p_, r, radius, color);
+    else
+      draw::rounded_rect_fill(p_, r, radius, color);
+  }
+
+  void gradient_round(rect r, i16 radius, u16 top_color, u16 bot_color) {
+    if (const u16* rows = gradient_rows(top_color, bot_color,
+                                        static_cast<i16>(r.h()))) {
+      if (theme_.antialias)
+        draw::rounded_rect_gradient_v_aa(p_, r, radius, rows);
+      else
+        draw::rounded_rect_gradient_v(p_, r, radius, rows);
+      return;
+    }
+    if (theme_.antialias)
+      draw::rounded_rect_gradient_v_aa(p_, r, radius, top_color, bot_color,
+                                       theme_.dither);
+    else
+      draw::rounded_rect_gradient_v(p_, r, radius, top_color, bot_color,
+                                    theme_.dither);
+  }
+
+  const u16* gradient_rows(u16 top_color, u16 bot_color, i16 h) {
+    if (theme_.dither || h <= 0 || h > gradient_cache_rows) return nullptr;
+    for (gradient_entry& e : gradient_cache_) {
+      if (e.h == h && e.top == top_color && e.bot == bot_color) return e.rows;
+    }
+    gradient_entry& e = gradient_cache_[gradient_next_];
+    gradient_next_ = (gradient_next_ + 1) % gradient_cache_size;
+    e.top = top_color;
+    e.bot = bot_color;
+    e.h = h;
+    draw::gradient_dda g(top_color, bot_color, h);
+    for (i16 y = 0; y < h; ++y, g.next()) e.rows[y] = g.color();
+    return e.rows;
+  }
+
+  static void auto_range(const series& data, i16& lo, i16& hi) {
+    if (lo < hi) return;
+    sample_span b = draw::series_bounds(data);
+    lo = b.empty() ? static_cast<i16>(0) : b.lo;
+    hi = b.empty() ? static_cast<i16>(1) : b.hi;
+    if (hi > lo) return;
+    if (lo == std::numeric_limits<i16>::max()) --lo;
+    hi = static_cast<i16>(lo + 1);
+  }
+
+  void fill_disc(i16 x, i16 y, i16 r, u16 color) {
+    if (theme_.antialias)
+      draw::fill_circle_aa(p_, x, y, r, color);
+    else
+      p_.fill_circle(x, y, r, color);
+  }
+
+  void fill_disc_blend(i16 x, i16 y, i16 r, u16 color, u8 alpha) {
+    if (theme_.antialias)
+      draw::fill_circle_blend_aa(p_, x, y, r, color, alpha);
+    else
+      draw::fill_circle_blend(p_, x, y, r, color, alpha);
+  }
+
+  void ring(i16 x, i16 y, i16 r, u16 color) {
+    if (theme_.antialias)
+      draw::arc_fill_aa(p_, x, y, r, r, 0, 360, color);
+    else
+      draw::circle_outline(p_, x, y, r, color);
+  }
+
+  void fill_arc(i16 x, i16 y, i16 outer_r, i16 inner_r, i16 start_deg,
+                i16 end_deg, u16 color) {
+    if (theme_.antialias)
+      draw::arc_fill_aa(p_, x, y, outer_r, inner_r, start_deg, end_deg, color);
+    else
+      draw::arc_fill(p_, x, y, outer_r, inner_r, start_deg, end_deg, color);
+  }
+
+  bool paint(id tag, rect r, u32 state, const char* text = nullptr) {
+    return paint(tag, r, state, text ? hash_label(text) : 0);
+  }
+
+  bool paint(id tag, rect r, u32 state, id text_hash) {
+    u32 pos = (static_cast<u32>(static_cast<u16>(r.x())) << 16) |
+              static_cast<u16>(r.y());
+    u32 size = (static_cast<u32>(r.w()) << 16) | r.h();
+    frame_hash_ = mix_id(frame_hash_, tag);
+    frame_hash_ = mix_id(frame_hash_, pos);
+    frame_hash_ = mix_id(frame_hash_, size);
+    frame_hash_ = mix_id(frame_hash_, state);
+    if (text_hash) frame_hash_ = mix_id(frame_hash_, text_hash);
+    if (active_panel_.scroll) {
+      u32 y = static_cast<u32>(r.y() + active_panel_.offset);
+      u32 h = mix_id(active_panel_.hash, tag);
+      h = mix_id(h, (static_cast<u32>(static_cast<u16>(r.x())) << 16) ^ y);
+      h = mix_id(h, size);
+      h = mix_id(h, state);
+      active_panel_.hash = mix_id(h, text_hash);
+    }
+    JEMGUI_STAT(stats_.widgets += tag != 0);
+    if (!painting_) return false;
+    if (!visible(r)) {
+      JEMGUI_STAT(stats_.culled += tag != 0);
+      return false;
+    }
+    if (tag != 0) overdraw(r);
+    return true;
+  }
+
+  void overdraw(rect r) {
+    for (scroll_entry& e : scroll_) {
+      if (e.drawn && e.frame.overlaps(r)) e.drawn = false;
+    }
+    for (plot_entry& e : plots_) {
+      if (!e.drawn || !e.r.overlaps(r)) continue;
+      rect c = e.r.intersect(r);
+      if (e.damaged < plot_damage_rects) {
+        e.damage[e.damaged++] = c;
+        continue;
+      }
+      rect& d = e.damage[plot_damage_rects - 1];
+      i16 x0 = std::min(c.x(), d.x());
+      i16 y0 = std::min(c.y(), d.y());
+      i16 x1 = std::max(c.right(), d.right());
+      i16 y1 = std::max(c.bottom(), d.bottom());
+      d = {{x0, y0}, {static_cast<u16>(x1 - x0), static_cast<u16>(y1 - y0)}};
+    }
+  }
+
+#if JEMGUI_STATS
+  u32 ticks() const { return clock_ ? clock_() : 0; }
+#endif
+
   u8 font_size() const {
     i16 scaled = s(static_cast<i16>(theme_.font_size));
     return scaled < 1 ? 1 : static_cast<u8>(scaled);
   }
 
-  static constexpr usize max_scroll_panels = 4;
+  struct text_metrics {
+    id hash;
+    i16 w;
+    i16 h;
+  };
+
+  text_metrics measure(const char* text, u8 fs) {
+    id hash = hash_label(text);
+    id key = mix_id(hash, fs);
+    u32 slot = (key * 0x9e3779b1u) >> (32 - text_cache_set_bits);
+    text_entry* set = &text_cache_[slot * text_cache_ways];
+    usize i = 0;
+    while (i < text_cache_ways - 1 && (set[i].key != key || key == 0)) ++i;
+    text_entry e = set[i];
+    if (e.key != key || key == 0) {
+      e = {key, draw::text_width(p_, text, fs), draw::text_height(p_, fs)};
+      JEMGUI_STAT(stats_.text_misses++);
+    }
+    for (; i > 0; --i) set[i] = set[i - 1];
+    set[0] = e;
+    return {hash, e.w, e.h};
+  }
+
+  void clear_text_cache() {
+    for (usize i = 0; i < text_cache_size; ++i) text_cache_[i] = {};
+  }
+
+  static constexpr usize max_scroll_panels = 8;
+  static constexpr usize max_plots = 4;
+  static constexpr usize plot_damage_rects = 4;
+  static constexpr usize max_clip_depth = 8;
+  static constexpr usize text_cache_set_bits = 4;
+  static constexpr usize text_cache_ways = 4;
+  static constexpr usize text_cache_size = text_cache_ways << text_cache_set_bits;
+  static constexpr usize gradient_cache_size = 4;
+  static constexpr i16 gradient_cache_rows = 64;
+
+  struct text_entry {
+    id key = 0;
+    i16 w = 0;
+    i16 h = 0;
+  };
+
+  struct gradient_entry {
+    u16 top = 0;
+    u16 bot = 0;
+    i16 h = 0;
+    u16 rows[gradient_cache_rows] = {};
+  };
 
   struct scroll_entry {
-    id pid = 0;
-    i16 offset = 0;
-    i16 content_h = 0;
+    i32 offset = 0;
+    i32 content_h = 0;
     i16 velocity = 0;
+    bool drawn = false;
+    bool held = false;
+    i32 drawn_offset = 0;
+    rect frame = {};
+    rect view = {};
+    u32 hash = 0;
+  };
+
+  struct plot_entry {
+    rect r = {};
+    u32 range = 0;
+    u16 per_col = 0;
+    u32 total = 0;
+    u32 column = 0;
+    bool drawn = false;
+    u8 damaged = 0;
+    rect damage[plot_damage_rects] = {};
+  };
+
+  struct list_state {
+    bool open = false;
+    bool row_open = false;
+    scroll_entry* scroll = nullptr;
+    const table_column* columns = nullptr;
+    usize column_count = 0;
+    usize col = 0;
+    rect body = {};
+    rect view = {};
+    i16 row_h = 0;
+    i16 pitch = 0;
+    i16 y0 = 0;
+    u32 first = 0;
   };
 
   struct panel_info {
-    i16 scroll_idx = -1;
+    scroll_entry* scroll = nullptr;
     rect clip = {};
+    rect frame = {};
+    rect view = {};
     i16 content_start_y = 0;
+    i32 offset = 0;
+    u32 hash = 2166136261u;
+    bool drawn = false;
+    bool banded = false;
   };
 
-  i16 find_scroll(id pid) {
-    for (usize i = 0; i < max_scroll_panels; ++i) {
-      if (scroll_[i].pid == pid) return static_cast<i16>(i);
+  void panel_chrome(rect r, const char* title, i16 title_h) {
+    fill_round(r, s(theme_.corner_radius), theme_.surface);
+    draw::rounded_rect_outline(p_, r, s(theme_.corner_radius), theme_.border);
+    if (!title) return;
+    rect head = r.shrink(s(theme_.padding));
+    rect title_r = {head.pos, {head.w(), static_cast<u16>(title_h)}};
+    draw::text_left(p_, title_r, title, theme_.text, font_size(), 0);
+    p_.hline(head.x(), static_cast<i16>(head.y() + title_h),
+             static_cast<i16>(head.w()), theme_.border);
+  }
+
+  i16 root_edge() const {
+    return static_cast<i16>(s(theme_.padding) + s(theme_.corner_radius));
+  }
+
+  void fill_edge(rect e) {
+    for (scroll_entry& se : scroll_) {
+      if (!se.held || !se.frame.overlaps(e)) continue;
+      rect hole = se.frame.intersect(e);
+      const rect parts[] = {
+          {e.pos, {e.w(), static_cast<u16>(hole.y() - e.y())}},
+          {{e.x(), hole.bottom()},
+           {e.w(), static_cast<u16>(e.bottom() - hole.bottom())}},
+          {{e.x(), hole.y()}, {static_cast<u16>(hole.x() - e.x()), hole.h()}},
+          {{hole.right(), hole.y()},
+           {static_cast<u16>(e.right() - hole.right()), hole.h()}},
+      };
+      for (const rect& part : parts) {
+        if (part.w() != 0 && part.h() != 0) fill_edge(part);
+      }
+      return;
     }
-    for (usize i = 0; i < max_scroll_panels; ++i) {
-      if (scroll_[i].pid == 0) {
-        scroll_[i].pid = pid;
-        return static_cast<i16>(i);
+    p_.fill_rect(e.x(), e.y(), static_cast<i16>(e.w()),
+                 static_cast<i16>(e.h()), theme_.bg);
+    overdraw(e);
+  }
+
+  bool reusable(const scroll_entry& se) const {
+    if constexpr (scroll_painter<P>) {
+      i32 delta = se.offset - se.drawn_offset;
+      i32 h = se.view.h();
+      return !input_.down() && !input_.released() && !anims_.any_active() &&
+             !theme_.dither && delta != 0 && delta > -h && delta < h;
+    }
+    return false;
+  }
+
+  rect scroll_band(scroll_entry& se, rect frame, rect view, rect area) {
+    se.held = false;
+    if (!painting_) return view;
+    bool drawn = se.drawn;
+    se.drawn = false;
+    if constexpr (scroll_painter<P>) {
+      i32 delta = se.offset - se.drawn_offset;
+      if (drawn && se.frame == frame && se.view == view && reusable(se)) {
+        p_.scroll_region(area, 0, static_cast<i16>(-delta));
+        if (delta > 0)
+          return {{view.x(), static_cast<i16>(view.bottom() - delta)},
+                  {view.w(), static_cast<u16>(delta)}};
+        return {view.pos, {view.w(), static_cast<u16>(-delta)}};
       }
     }
-    return -1;
+    return view;
+  }
+
+  void scroll_drag(scroll_entry& se, rect view, id owner = 0) {
+    i32 max_scroll = std::max<i32>(se.content_h - view.h(), 0);
+    if ((active_ == 0 || active_ == owner) && input_.held()) {
+      if (view.contains(input_.pos()) || view.contains(input_.prev_pos())) {
+        i16 dy = static_cast<i16>(input_.pos().y - input_.prev_pos().y);
+        se.offset -= dy;
+        se.velocity = static_cast<i16>(-dy * 4);
+      }
+    } else if (!input_.down() && se.velocity != 0) {
+      se.offset += se.velocity / 4;
+      if (se.velocity > 0)
+        se.velocity = static_cast<i16>(se.velocity - 1);
+      else if (se.velocity < 0)
+        se.velocity = static_cast<i16>(se.velocity + 1);
+    }
+    se.offset = std::clamp<i32>(se.offset, 0, max_scroll);
+  }
+
+  void scrollbar(rect view, const scroll_entry& se) {
+    i32 visible_h = view.h();
+    i32 max_scroll = se.content_h - visible_h;
+    if (max_scroll <= 0) return;
+    i16 bar_w = s(3);
+    i16 bar_x = static_cast<i16>(view.right() - bar_w);
+    i16 bar_h = static_cast<i16>(view.h());
+    i16 thumb_h = static_cast<i16>(bar_h * visible_h / se.content_h);
+    if (thumb_h < s(8)) thumb_h = s(8);
+    i16 thumb_y = static_cast<i16>(view.y() + static_cast<i64>(se.offset) *
+                                                   (bar_h - thumb_h) /
+                                                   max_scroll);
+    rect bar_r = {{bar_x, view.y()},
+                  {static_cast<u16>(bar_w), static_cast<u16>(bar_h)}};
+    u32 state = (static_cast<u32>(static_cast<u16>(thumb_y)) << 16) |
+                static_cast<u16>(thumb_h);
+    if (paint(0x5C0, bar_r, state)) {
+      p_.fill_rect(bar_x, view.y(), bar_w, bar_h, theme_.surface_alt);
+      fill_round(rect{{bar_x, thumb_y},
+                      {static_cast<u16>(bar_w), static_cast<u16>(thumb_h)}},
+                 static_cast<i16>(bar_w / 2), theme_.border);
+    }
+  }
+
+  u16 column_width(const table_column& col, u16 rest) const {
+    if (col.width <= 0) return rest;
+    return std::min<u16>(static_cast<u16>(s(col.width)), rest);
+  }
+
+  list_range begin_list(const char* name, const table_column* columns,
+                        usize column_count, u32 count, i16 row_h,
+                        i16 height) {
+    list_end();
+    id lid = ids_.make(name);
+    i16 rh = row_h > 0 ? s(row_h) : s(theme_.widget_height);
+    i16 pitch = columns ? rh : static_cast<i16>(rh + s(theme_.spacing));
+    i16 h = height > 0 ? s(height)
+                       : static_cast<i16>(current_clip().bottom() -
+                                          layout_.top().cursor.y -
+                                          layout_.top().spacing);
+    h = std::max(h, static_cast<i16>(columns ? 2 * rh : rh));
+    rect r = layout_.allocate(layout_.available_w(), static_cast<u16>(h));
+    rect body = r;
+    if (columns) {
+      body.pos.y = static_cast<i16>(body.y() + rh);
+      body.size.h = static_cast<u16>(body.h() - rh);
+    }
+
+    list_ = {};
+    list_.open = true;
+    list_.columns = columns;
+    list_.column_count = column_count;
+    list_.row_h = rh;
+    list_.pitch = pitch;
+    list_.body = body;
+    list_.scroll = scroll_.get(lid);
+    scroll_entry fixed = {};
+    scroll_entry& se = list_.scroll ? *list_.scroll : fixed;
+    se.content_h = static_cast<i32>(count) * pitch;
+    if (input_.pressed_in(body)) drag_ = lid;
+    if (drag_ == lid && input_.held() &&
+        input_.pos().y != input_.prev_pos().y)
+      active_ = lid;
+    scroll_drag(se, body, lid);
+
+    list_.view = body;
+    i16 bar_space = static_cast<i16>(s(4) + s(2));
+    if (se.content_h > body.h() && body.w() > bar_space)
+      list_.view.size.w = static_cast<u16>(body.w() - bar_space);
+
+    rect seen = current_clip().intersect(body);
+    bool shown = visible(r) && seen.h() > 0;
+    i32 top = se.offset + (seen.y() - body.y());
+    u32 first = shown ? static_cast<u32>(top / pitch) : 0;
+    u32 last = shown ? std::min<u32>(count, static_cast<u32>(
+                                                (top + seen.h() + pitch - 1) /
+                                                pitch))
+                     : 0;
+    list_.first = first;
+    list_.y0 = static_cast<i16>(body.y() + static_cast<i32>(first) * pitch -
+                                se.offset);
+
+    if (paint(0x715, r, static_cast<u32>(se.offset))) {
+      p_.fill_rect(body.x(), body.y(), static_cast<i16>(body.w()),
+                   static_cast<i16>(body.h()), theme_.surface);
+      if (columns) table_header(r);
+    }
+
+    push_clip(body);
+    ids_.push(lid);
+    layout_.push({
+        .bounds = list_.view,
+        .cursor = {list_.view.x(), list_.y0},
+        .dir = direction::vertical,
+        .culled = !shown,
+    });
+    return {this, first, last};
+  }
+
+  void table_header(rect r) {
+    rect head = {r.pos, {r.w(), static_cast<u16>(list_.row_h)}};
+    p_.fill_rect(head.x(), head.y(), static_cast<i16>(head.w()),
+                 static_cast<i16>(head.h()), theme_.surface_alt);
+    u8 fs = font_size();
+    i16 x = head.x();
+    i16 right = list_.view.right();
+    for (usize i = 0; i < list_.column_count && x < right; ++i) {
+      const table_column& col = list_.columns[i];
+      u16 w = column_width(col, static_cast<u16>(right - x));
+      rect cell = {{x, head.y()}, {w, head.h()}};
+      push_clip(cell);
+      draw::text_left(p_, cell, col.title ? col.title : "", theme_.text_dim, fs,
+                      s(theme_.padding));
+      pop_clip();
+      x = static_cast<i16>(x + w);
+    }
+    p_.hline(head.x(), static_cast<i16>(head.bottom() - 1),
+             static_cast<i16>(head.w()), theme_.border);
+  }
+
+  void list_row(u32 i) {
+    if (list_.row_open) {
+      end();
+      pop_id();
+    }
+    i16 y = static_cast<i16>(list_.y0 +
+                             static_cast<i32>(i - list_.first) * list_.pitch);
+    layout_.top().cursor = {list_.view.x(), y};
+    rect r = layout_.allocate(list_.view.w(), static_cast<u16>(list_.row_h));
+    if (list_.columns && (i & 1) && paint(0x7A1, r, i))
+      p_.fill_rect(r.x(), r.y(), static_cast<i16>(r.w()),
+                   static_cast<i16>(r.h()), theme_.surface_alt);
+    ids_.push(static_cast<id>(i));
+    layout_.push({
+        .bounds = r,
+        .cursor = r.pos,
+        .dir = direction::horizontal,
+        .spacing = list_.columns ? static_cast<i16>(0) : s(theme_.spacing),
+        .culled = !visible(r),
+    });
+    list_.row_open = true;
+    list_.col = 0;
   }
 
   P& p_;
@@ -894,9 +1677,29 @@ class ctx {
   anim_pool anims_;
   id hot_ = 0;
   id active_ = 0;
+  id drag_ = 0;
   i16 scale_ = 256;
-  scroll_entry scroll_[max_scroll_panels] = {};
+  state_table<id, scroll_entry, max_scroll_panels> scroll_;
+  state_table<id, plot_entry, max_plots> plots_;
+  rect clip_stack_[max_clip_depth] = {};
+  usize clip_depth_ = 0;
+  text_entry text_cache_[text_cache_size] = {};
+  gradient_entry gradient_cache_[gradient_cache_size] = {};
+  usize gradient_next_ = 0;
   panel_info active_panel_ = {};
+  list_state list_ = {};
+  bool frame_skip_ = false;
+  bool force_paint_ = true;
+  bool can_skip_ = false;
+  bool painting_ = true;
+  u32 frame_hash_ = 0;
+  u32 last_hash_ = 0;
+#if JEMGUI_STATS
+  stats_clock clock_ = nullptr;
+  frame_stats stats_ = {};
+  frame_stats last_stats_ = {};
+  u32 widgets_t0_ = 0;
+#endif
 };
 
 }  // namespace jemgui
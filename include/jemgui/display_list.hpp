@@ -0,0 +1,363 @@
+#pragma once
+
+#include <cstring>
+#include <jemgui/painter.hpp>
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+enum class draw_op : u8 {
+  nop,
+  fill_rect,
+  hline,
+  vline,
+  pixel,
+  circle,
+  text,
+  clip,
+  clear_clip,
+  fill_rect_blend,
+};
+
+struct draw_cmd {
+  draw_op op = draw_op::nop;
+  u8 size = 0;
+  u16 color = 0;
+  i16 x = 0;
+  i16 y = 0;
+  i16 w = 0;
+  i16 h = 0;
+};
+
+template <usize Capacity = 16384>
+class display_list {
+ public:
+  display_list(u16 w, u16 h) : w_{w}, h_{h} {}
+
+  u16 width() const { return w_; }
+  u16 height() const { return h_; }
+
+  void resize(u16 w, u16 h) {
+    w_ = w;
+    h_ = h;
+  }
+
+  void clear() {
+    used_ = 0;
+    overflowed_ = false;
+    if (has_clip_) set_clip(clip_);
+  }
+
+  bool empty() const { return used_ == 0; }
+  bool overflowed() const { return overflowed_; }
+  usize bytes_used() const { return used_; }
+  const u8* data() const { return arena_; }
+
+  bool operator==(const display_list& o) const {
+    return used_ == o.used_ && std::memcmp(arena_, o.arena_, used_) == 0;
+  }
+
+  u32 hash() const {
+    u32 h = 2166136261u;
+    for (usize i = 0; i < used_; ++i) h = (h ^ arena_[i]) * 16777619u;
+    return h;
+  }
+
+  void set_clip(rect r) {
+    clip_ = r;
+    has_clip_ = true;
+    push({.op = draw_op::clip,
+          .x = r.x(),
+          .y = r.y(),
+          .w = static_cast<i16>(r.w()),
+          .h = static_cast<i16>(r.h())});
+  }
+
+  void clear_clip() {
+    has_clip_ = false;
+    push({.op = draw_op::clear_clip});
+  }
+
+  void pixel(i16 x, i16 y, u16 color) {
+    push({.op = draw_op::pixel, .color = color, .x = x, .y = y});
+  }
+
+  void hline(i16 x, i16 y, i16 length, u16 color) {
+    if (length <= 0) return;
+    push({.op = draw_op::hline, .color = color, .x = x, .y = y, .w = length});
+  }
+
+  void vline(i16 x, i16 y, i16 vh, u16 color) {
+    if (vh <= 0) return;
+    push({.op = draw_op::vline, .color = color, .x = x, .y = y, .h = vh});
+  }
+
+  void fill_rect(i16 x, i16 y, i16 w, i16 h, u16 color) {
+    if (w <= 0 || h <= 0) return;
+    push({.op = draw_op::fill_rect,
+          .color = color,
+          .x = x,
+          .y = y,
+          .w = w,
+          .h = h});
+  }
+
+  void hline_blend(i16 x, i16 y, i16 length, u16 color, u8 alpha) {
+    fill_rect_blend(x, y, length, 1, color, alpha);
+  }
+
+  void fill_rect_blend(i16 x, i16 y, i16 w, i16 h, u16 color, u8 alpha) {
+    if (w <= 0 || h <= 0 || alpha == 0) return;
+    push({.op = draw_op::fill_rect_blend,
+          .size = alpha,
+          .color = color,
+          .x = x,
+          .y = y,
+          .w = w,
+          .h = h});
+  }
+
+  void fill_circle(i16 x0, i16 y0, i16 r, u16 color) {
+    push({.op = draw_op::circle, .color = color, .x = x0, .y = y0, .w = r});
+  }
+
+  void set_cursor(i16 x, i16 y) {
+    cx_ = x;
+    cy_ = y;
+  }
+
+  void set_text_color(u16 c) { tc_ = c; }
+
+  void set_text_size(u8 s) { ts_ = s; }
+
+  void print(const char* str) {
+    usize len = std::strlen(str);
+    i16 lines = 1;
+    for (usize i = 0; i < len; ++i)
+      if (str[i] == '\n') lines++;
+    draw_cmd c = {.op = draw_op::text,
+                  .size = ts_,
+                  .color = tc_,
+                  .x = cx_,
+                  .y = cy_,
+                  .w = static_cast<i16>(len),
+                  .h = static_cast<i16>(8 * ts_ * lines)};
+    if (used_ + sizeof(draw_cmd) + len > Capacity) {
+      overflowed_ = true;
+    } else {
+      std::memcpy(arena_ + used_, &c, sizeof(draw_cmd));
+      std::memcpy(arena_ + used_ + sizeof(draw_cmd), str, len);
+      used_ += sizeof(draw_cmd) + len;
+    }
+    for (usize i = 0; i < len; ++i) {
+      if (str[i] == '\n') {
+        cx_ = 0;
+        cy_ = static_cast<i16>(cy_ + 8 * ts_);
+      } else {
+        cx_ = static_cast<i16>(cx_ + 6 * ts_);
+      }
+    }
+  }
+
+  template <typename F>
+  void for_each(F&& f) const {
+    usize at = 0;
+    while (at < used_) {
+      draw_cmd c;
+      std::memcpy(&c, arena_ + at, sizeof(draw_cmd));
+      at += sizeof(draw_cmd);
+      const char* text = reinterpret_cast<const char*>(arena_ + at);
+      if (c.op == draw_op::text) at += static_cast<usize>(c.w);
+      f(c, text);
+    }
+  }
+
+  static rect bounds(const draw_cmd& c, const char* text) {
+    auto make = [](i32 x0, i32 y0, i32 x1, i32 y1) -> rect {
+      if (x1 <= x0 || y1 <= y0) return {};
+      return {{static_cast<i16>(x0), static_cast<i16>(y0)},
+              {static_cast<u16>(x1 - x0), static_cast<u16>(y1 - y0)}};
+    };
+    switch (c.op) {
+      case draw_op::fill_rect:
+      case draw_op::fill_rect_blend:
+        return make(c.x, c.y, c.x + c.w, c.y + c.h);
+      case draw_op::hline:
+        return make(c.x, c.y, c.x + c.w, c.y + 1);
+      case draw_op::vline:
+        return make(c.x, c.y, c.x + 1, c.y + c.h);
+      case draw_op::pixel:
+        return make(c.x, c.y, c.x + 1, c.y + 1);
+      case draw_op::circle:
+        return make(c.x - c.w, c.y - c.w, c.x + c.w + 1, c.y + c.w + 1);
+      case draw_op::text: {
+        i32 x0 = c.x;
+        i32 x = c.x;
+        i32 x1 = c.x;
+        for (i16 i = 0; i < c.w; ++i) {
+          if (text[i] == '\n') {
+            x = 0;
+            x0 = 0;
+          } else {
+            x += 6 * c.size;
+            if (x > x1) x1 = x;
+          }
+        }
+        return make(x0, c.y, x1, c.y + c.h);
+      }
+      default:
+        return {};
+    }
+  }
+
+  template <painter P>
+  void replay(P& p) const {
+    for_each([&](const draw_cmd& c, const char* text) {
+      emit(p, c, text, 0, 0);
+    });
+  }
+
+  template <painter P>
+  void replay(P& p, rect window) const {
+    i16 dx = window.x();
+    i16 dy = window.y();
+    for_each([&](const draw_cmd& c, const char* text) {
+      if (c.op != draw_op::clip && c.op != draw_op::clear_clip &&
+          !bounds(c, text).overlaps(window))
+        return;
+      emit(p, c, text, dx, dy);
+    });
+  }
+
+  void cull_occluded() {
+    rect clip_i = {};
+    bool has_clip_i = false;
+    usize out = 0;
+    usize at = 0;
+    while (at < used_) {
+      draw_cmd c;
+      std::memcpy(&c, arena_ + at, sizeof(draw_cmd));
+      usize n = sizeof(draw_cmd) +
+                (c.op == draw_op::text ? static_cast<usize>(c.w) : 0);
+      bool keep = c.op != draw_op::nop;
+      if (c.op == draw_op::clip) {
+        clip_i = {{c.x, c.y}, {static_cast<u16>(c.w), static_cast<u16>(c.h)}};
+        has_clip_i = true;
+      } else if (c.op == draw_op::clear_clip) {
+        has_clip_i = false;
+      } else if (keep) {
+        rect b = bounds(c, reinterpret_cast<const char*>(arena_ + at +
+                                                         sizeof(draw_cmd)));
+        if (has_clip_i) b = b.intersect(clip_i);
+        keep = b.size.area() != 0 && !covered_after(at + n, b, clip_i,
+                                                     has_clip_i);
+      }
+      if (keep) {
+        if (out != at) std::memmove(arena_ + out, arena_ + at, n);
+        out += n;
+      }
+      at += n;
+    }
+    used_ = out;
+  }
+
+ private:
+  static bool encloses(rect outer, rect inner) {
+    return inner.x() >= outer.x() && inner.y() >= outer.y() &&
+           inner.right() <= outer.right() && inner.bottom() <= outer.bottom();
+  }
+
+  bool covered_after(usize at, rect b, rect clip, bool has_clip) const {
+    while (at < used_) {
+      draw_cmd c;
+      std::memcpy(&c, arena_ + at, sizeof(draw_cmd));
+      at += sizeof(draw_cmd);
+      if (c.op == draw_op::text) {
+        at += static_cast<usize>(c.w);
+      } else if (c.op == draw_op::clip) {
+        clip = {{c.x, c.y}, {static_cast<u16>(c.w), static_cast<u16>(c.h)}};
+        has_clip = true;
+      } else if (c.op == draw_op::clear_clip) {
+        has_clip = false;
+      } else if (c.op == draw_op::fill_rect) {
+        rect cover = bounds(c, nullptr);
+        if (has_clip) cover = cover.intersect(clip);
+        if (encloses(cover, b)) return true;
+      }
+    }
+    return false;
+  }
+
+  template <painter P>
+  static void emit(P& p, const draw_cmd& c, const char* text, i16 dx, i16 dy) {
+    i16 x = static_cast<i16>(c.x - dx);
+    i16 y = static_cast<i16>(c.y - dy);
+    switch (c.op) {
+      case draw_op::fill_rect:
+        p.fill_rect(x, y, c.w, c.h, c.color);
+        break;
+      case draw_op::fill_rect_blend:
+        if constexpr (blend_painter<P>)
+          p.fill_rect_blend(x, y, c.w, c.h, c.color, c.size);
+        else if (c.size >= 128)
+          p.fill_rect(x, y, c.w, c.h, c.color);
+        break;
+      case draw_op::hline:
+        p.hline(x, y, c.w, c.color);
+        break;
+      case draw_op::vline:
+        p.vline(x, y, c.h, c.color);
+        break;
+      case draw_op::pixel:
+        p.pixel(x, y, c.color);
+        break;
+      case draw_op::circle:
+        p.fill_circle(x, y, c.w, c.color);
+        break;
+      case draw_op::text: {
+        char chunk[33];
+        p.set_cursor(x, y);
+        p.set_text_color(c.color);
+        p.set_text_size(c.size);
+        for (i16 i = 0; i < c.w; i = static_cast<i16>(i + 32)) {
+          i16 n = std::min<i16>(32, static_cast<i16>(c.w - i));
+          std::memcpy(chunk, text + i, static_cast<usize>(n));
+          chunk[n] = '\0';
+          p.print(chunk);
+        }
+        break;
+      }
+      case draw_op::clip:
+        p.set_clip({{x, y}, {static_cast<u16>(c.w), static_cast<u16>(c.h)}});
+        break;
+      case draw_op::clear_clip:
+        p.clear_clip();
+        break;
+      case draw_op::nop:
+        break;
+    }
+  }
+
+  void push(const draw_cmd& c) {
+    if (used_ + sizeof(draw_cmd) > Capacity) {
+      overflowed_ = true;
+      return;
+    }
+    std::memcpy(arena_ + used_, &c, sizeof(draw_cmd));
+    used_ += sizeof(draw_cmd);
+  }
+
+  u16 w_;
+  u16 h_;
+  u8 arena_[Capacity] = {};
+  usize used_ = 0;
+  bool overflowed_ = false;
+  rect clip_ = {};
+  bool has_clip_ = false;
+  i16 cx_ = 0;
+  i16 cy_ = 0;
+  u16 tc_ = 0xFFFF;
+  u8 ts_ = 1;
+};
+
+}  // namespace jemgui
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
 #include <jemgui/color.hpp>
 #include <jemgui/painter.hpp>
 #include <jemgui/types.hpp>
@@ -7,146 +10,274 @@
 
 namespace jemgui::draw {
 
+class gradient_dda {
+ public:
+  constexpr gradient_dda(u16 from, u16 to, i16 steps)
+      : den_{steps > 1 ? steps - 1 : 1} {
+    constexpr u8 shift[3] = {11, 5, 0};
+    constexpr u16 mask[3] = {0x1F, 0x3F, 0x1F};
+    for (usize i = 0; i < 3; ++i) {
+      i32 a = (from >> shift[i]) & mask[i];
+      i32 d = ((to >> shift[i]) & mask[i]) - a;
+      i32 m = d < 0 ? -d : d;
+      v_[i] = a;
+      step_[i] = d < 0 ? -1 : 1;
+      dq_[i] = step_[i] * (m / den_);
+      dr_[i] = m % den_;
+    }
+  }
+
+  constexpr u16 color() const { return pack(v_[0], v_[1], v_[2]); }
+
+  constexpr u16 color(u8 threshold) const {
+    i32 t = (2 * static_cast<i32>(threshold) + 1) * den_;
+    return pack(r_[0] * 32 > t ? v_[0] + step_[0] : v_[0],
+                r_[1] * 32 > t ? v_[1] + step_[1] : v_[1],
+                r_[2] * 32 > t ? v_[2] + step_[2] : v_[2]);
+  }
+
+  constexpr void next() {
+    for (usize i = 0; i < 3; ++i) {
+      v_[i] += dq_[i];
+      r_[i] += dr_[i];
+      if (r_[i] >= den_) {
+        r_[i] -= den_;
+        v_[i] += step_[i];
+      }
+    }
+  }
+
+ private:
+  static constexpr u16 pack(i32 cr, i32 cg, i32 cb) {
+    return static_cast<u16>(((cr & 0x1F) << 11) | ((cg & 0x3F) << 5) |
+                            (cb & 0x1F));
+  }
+
+  i32 den_;
+  i32 v_[3] = {};
+  i32 step_[3] = {};
+  i32 dq_[3] = {};
+  i32 dr_[3] = {};
+  i32 r_[3] = {};
+};
+
+namespace detail {
+
+inline constexpr u8 bayer4[4][4] = {
+    {0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+template <painter P>
+void gradient_span(P& p, i16 x, i16 y, i16 w, const gradient_dda& g,
+                   bool dither) {
+  if (!dither) return p.hline(x, y, w, g.color());
+  u16 c[4];
+  for (i16 i = 0; i < 4; ++i) c[i] = g.color(bayer4[y & 3][(x + i) & 3]);
+  if (c[0] == c[1] && c[1] == c[2] && c[2] == c[3])
+    return p.hline(x, y, w, c[0]);
+  for (i16 i = 0; i < w; ++i)
+    p.pixel(static_cast<i16>(x + i), y, c[i & 3]);
+}
+
+template <painter P, typename Span, typename Color>
+void rounded_rect_shaded(P& p, rect r, i16 radius, bool aa, Span&& span,
+                         Color&& color) {
+  if (radius <= 0 || r.w() < 2 * radius || r.h() < 2 * radius) {
+    for (i16 y = r.y(); y < r.bottom(); ++y)
+      span(y, r.x(), static_cast<i16>(r.w()));
+    return;
+  }
+  if (!aa) return rounded_rect_rows(r, std::min<i16>(radius, 255), span);
+  rounded_rect_rows_aa(
+      r, radius, span,
+      [&](i16 x, i16 y, u8 a) { blend_pixel(p, x, y, color(y), a); },
+      [&](i16 y0, i16 h) {
+        for (i16 y = y0; y < y0 + h; ++y)
+          span(y, r.x(), static_cast<i16>(r.w()));
+      });
+}
+
+template <painter P>
+void rounded_rect_gradient(P& p, rect r, i16 radius, u16 top_color,
+                           u16 bot_color, bool dither, bool aa) {
+  if (r.h() == 0 || r.w() == 0) return;
+  gradient_dda g(top_color, bot_color, static_cast<i16>(r.h()));
+  i16 row = r.y();
+  auto at = [&](i16 y) -> const gradient_dda& {
+    for (; row < y; ++row) g.next();
+    return g;
+  };
+  rounded_rect_shaded(
+      p, r, radius, aa,
+      [&](i16 y, i16 x, i16 w) { gradient_span(p, x, y, w, at(y), dither); },
+      [&](i16 y) { return at(y).color(); });
+}
+
+template <painter P>
+void rounded_rect_rows_colored(P& p, rect r, i16 radius, const u16* rows,
+                               bool aa) {
+  rounded_rect_shaded(
+      p, r, radius, aa,
+      [&](i16 y, i16 x, i16 w) { p.hline(x, y, w, rows[y - r.y()]); },
+      [&](i16 y) { return rows[y - r.y()]; });
+}
+
+}  // namespace detail
+
 template <painter P>
-void gradient_v(P& p, rect r, u16 top_color, u16 bot_color) {
+void gradient_v(P& p, rect r, u16 top_color, u16 bot_color,
+                bool dither = false) {
   if (r.h() == 0) return;
-  i32 tr = (top_color >> 11) & 0x1F;
-  i32 tg = (top_color >> 5) & 0x3F;
-  i32 tb = top_color & 0x1F;
-  i32 br = (bot_color >> 11) & 0x1F;
-  i32 bg = (bot_color >> 5) & 0x3F;
-  i32 bb = bot_color & 0x1F;
-  i16 h = static_cast<i16>(r.h());
-  i32 hm1 = h > 1 ? h - 1 : 1;
-  for (i16 y = 0; y < h; ++y) {
-    i32 cr = tr + (br - tr) * y / hm1;
-    i32 cg = tg + (bg - tg) * y / hm1;
-    i32 cb = tb + (bb - tb) * y / hm1;
-    u16 c = static_cast<u16>(((cr & 0x1F) << 11) | ((cg & 0x3F) << 5) |
-                             (cb & 0x1F));
-    p.hline(r.x(), static_cast<i16>(r.y() + y), static_cast<i16>(r.w()), c);
+  gradient_dda g(top_color, bot_color, static_cast<i16>(r.h()));
+  for (i16 y = r.y(); y < r.bottom(); ++y) {
+    detail::gradient_span(p, r.x(), y, static_cast<i16>(r.w()), g, dither);
+    g.next();
   }
 }
 
 template <painter P>
-void gradient_h(P& p, rect r, u16 left_color, u16 right_color) {
+void gradient_h(P& p, rect r, u16 left_color, u16 right_color,
+                bool dither = false) {
   if (r.w() == 0) return;
-  i32 lr = (left_color >> 11) & 0x1F;
-  i32 lg = (left_color >> 5) & 0x3F;
-  i32 lb = left_color & 0x1F;
-  i32 rr = (right_color >> 11) & 0x1F;
-  i32 rg = (right_color >> 5) & 0x3F;
-  i32 rb = right_color & 0x1F;
-  i16 w = static_cast<i16>(r.w());
-  i32 wm1 = w > 1 ? w - 1 : 1;
-  for (i16 x = 0; x < w; ++x) {
-    i32 cr = lr + (rr - lr) * x / wm1;
-    i32 cg = lg + (rg - lg) * x / wm1;
-    i32 cb = lb + (rb - lb) * x / wm1;
-    u16 c = static_cast<u16>(((cr & 0x1F) << 11) | ((cg & 0x3F) << 5) |
-                             (cb & 0x1F));
-    p.vline(static_cast<i16>(r.x() + x), r.y(), static_cast<i16>(r.h()), c);
-  }
-}
-
-template <painter P>
-void shadow(P& p, rect r, i16 radius, u16 bg_color, u8 layers = 3,
-            i16 offset_x = 2, i16 offset_y = 2) {
-  for (i16 i = layers; i > 0; --i) {
-    u8 alpha = static_cast<u8>(40 / i);
-    u16 sc = blend_rgb565(0x0000, bg_color, alpha);
-    rect sr = {
-        {static_cast<i16>(r.x() + offset_x + i),
-         static_cast<i16>(r.y() + offset_y + i)},
-        {static_cast<u16>(r.w() + i * 2), static_cast<u16>(r.h() + i * 2)},
-    };
-    rounded_rect_fill(p, sr, static_cast<i16>(radius + i), sc);
+  gradient_dda g(left_color, right_color, static_cast<i16>(r.w()));
+  i16 h = static_cast<i16>(r.h());
+  for (i16 x = r.x(); x < r.right(); ++x) {
+    u16 c[4];
+    for (i16 i = 0; i < 4; ++i)
+      c[i] = dither ? g.color(detail::bayer4[(r.y() + i) & 3][x & 3])
+                    : g.color();
+    if (c[0] == c[1] && c[1] == c[2] && c[2] == c[3]) {
+      p.vline(x, r.y(), h, c[0]);
+    } else {
+      for (i16 i = 0; i < h; ++i)
+        p.pixel(x, static_cast<i16>(r.y() + i), c[i & 3]);
+    }
+    g.next();
   }
 }
 
-template <painter P>
-void rounded_rect_gradient_v(P& p, rect r, i16 radius, u16 top_color,
-                             u16 bot_color) {
-  if (r.h() == 0 || r.w() == 0) return;
+inline constexpr i16 shadow_table_blur = 16;
+inline constexpr u8 shadow_alpha = 40;
 
-  i32 tr = (top_color >> 11) & 0x1F;
-  i32 tg = (top_color >> 5) & 0x3F;
-  i32 tb = top_color & 0x1F;
-  i32 br = (bot_color >> 11) & 0x1F;
-  i32 bg = (bot_color >> 5) & 0x3F;
-  i32 bb = bot_color & 0x1F;
-  i16 h = static_cast<i16>(r.h());
-  i32 hm1 = h > 1 ? h - 1 : 1;
+struct shadow_table {
+  u8 falloff[shadow_table_blur * (shadow_table_blur + 1) / 2] = {};
 
-  if (radius <= 0 || r.w() < 2 * radius || r.h() < 2 * radius) {
-    gradient_v(p, r, top_color, bot_color);
-    return;
+  constexpr shadow_table() {
+    for (i16 blur = 1; blur <= shadow_table_blur; ++blur) {
+      u8* f = falloff + blur * (blur - 1) / 2;
+      for (i16 k = 1; k <= blur; ++k) {
+        i32 t = k * 256 / (blur + 1);
+        i32 s = (t * t * (768 - 2 * t)) >> 16;
+        f[k - 1] = static_cast<u8>(std::min<i32>(256 - s, 255));
+      }
+    }
   }
 
-  auto color_at = [&](i16 y) -> u16 {
-    i32 cr = tr + (br - tr) * static_cast<i32>(y) / hm1;
-    i32 cg = tg + (bg - tg) * static_cast<i32>(y) / hm1;
-    i32 cb = tb + (bb - tb) * static_cast<i32>(y) / hm1;
-    return static_cast<u16>(((cr & 0x1F) << 11) | ((cg & 0x3F) << 5) |
-                            (cb & 0x1F));
-  };
+  constexpr const u8* get(i16 blur) const {
+    return falloff + blur * (blur - 1) / 2;
+  }
+};
 
-  for (i16 y = radius; y < h - radius; ++y) {
-    u16 c = color_at(y);
-    p.hline(r.x(), static_cast<i16>(r.y() + y), static_cast<i16>(r.w()), c);
+inline constexpr shadow_table shadow_profiles;
+
+template <painter P>
+void shadow(P& p, rect r, i16 radius, u16 bg_color, u8 blur = 3,
+            i16 offset_x = 2, i16 offset_y = 2) {
+  if (r.w() == 0 || r.h() == 0) return;
+  i16 b = std::clamp<i16>(blur, 1, shadow_table_blur);
+  radius = std::clamp<i16>(
+      radius, 0, static_cast<i16>(std::min<i16>(r.w(), r.h()) / 2));
+  radius = std::min<i16>(radius, 255);
+
+  const u8* falloff = shadow_profiles.get(b);
+  u8 alpha[shadow_table_blur + 1];
+  i32 lim[shadow_table_blur + 1];
+  for (i16 k = 0; k <= b; ++k) {
+    alpha[k] = k == 0 ? shadow_alpha
+                      : static_cast<u8>((falloff[k - 1] * shadow_alpha) >> 8);
+    lim[k] = static_cast<i32>(radius + k) * (radius + k);
   }
 
-  i16 cx_l = static_cast<i16>(r.x() + radius);
-  i16 cx_r = static_cast<i16>(r.right() - radius - 1);
+  u8 scratch[256];
+  const u8* inset = radius ? corner_insets(radius, scratch) : nullptr;
+  i16 h = static_cast<i16>(r.h());
+  i16 cl = static_cast<i16>(r.x() + offset_x + radius);
+  i16 cr = static_cast<i16>(r.right() - 1 + offset_x - radius);
+  i16 ct = static_cast<i16>(r.y() + offset_y + radius);
+  i16 cb = static_cast<i16>(r.bottom() - 1 + offset_y - radius);
+  i16 x_lo = static_cast<i16>(cl - radius - b);
+  i16 x_hi = static_cast<i16>(cr + radius + b + 1);
 
-  i16 f = 1 - radius;
-  i16 dd_f_x = 1;
-  i16 dd_f_y = -2 * radius;
-  i16 px = 0;
-  i16 py = radius;
-
-  while (px <= py) {
-    i16 y_top_py = static_cast<i16>(radius - py);
-    i16 y_top_px = static_cast<i16>(radius - px);
-    i16 y_bot_py = static_cast<i16>(h - 1 - radius + py);
-    i16 y_bot_px = static_cast<i16>(h - 1 - radius + px);
-
-    {
-      u16 c = color_at(y_top_py);
-      i16 x0 = static_cast<i16>(cx_l - px);
-      i16 w2 = static_cast<i16>(cx_r - cx_l + 2 * px + 1);
-      p.hline(x0, static_cast<i16>(r.y() + y_top_py), w2, c);
-    }
-    {
-      u16 c = color_at(y_top_px);
-      i16 x0 = static_cast<i16>(cx_l - py);
-      i16 w2 = static_cast<i16>(cx_r - cx_l + 2 * py + 1);
-      p.hline(x0, static_cast<i16>(r.y() + y_top_px), w2, c);
-    }
-    {
-      u16 c = color_at(y_bot_py);
-      i16 x0 = static_cast<i16>(cx_l - px);
-      i16 w2 = static_cast<i16>(cx_r - cx_l + 2 * px + 1);
-      p.hline(x0, static_cast<i16>(r.y() + y_bot_py), w2, c);
+  auto emit = [&](i16 x, i16 y, i16 n, u8 a) {
+    if constexpr (blend_painter<P>) {
+      p.hline_blend(x, y, n, 0x0000, a);
+    } else if constexpr (readable_painter<P>) {
+      for (i16 i = 0; i < n; ++i) {
+        i16 px = static_cast<i16>(x + i);
+        p.pixel(px, y, blend_rgb565(0x0000, p.read_pixel(px, y), a));
+      }
+    } else {
+      p.hline(x, y, n, blend_rgb565(0x0000, bg_color, a));
     }
-    {
-      u16 c = color_at(y_bot_px);
-      i16 x0 = static_cast<i16>(cx_l - py);
-      i16 w2 = static_cast<i16>(cx_r - cx_l + 2 * py + 1);
-      p.hline(x0, static_cast<i16>(r.y() + y_bot_px), w2, c);
+  };
+
+  auto run = [&](i16 x0, i16 x1, i16 y, i32 y2) {
+    i16 start = x0;
+    i16 prev = b + 1;
+    for (i16 x = x0; x <= x1; ++x) {
+      i16 k = b + 1;
+      if (x < x1) {
+        i32 dx = std::max({cl - x, x - cr, 0});
+        i32 d2 = y2 + dx * dx;
+        k = 0;
+        while (k <= b && d2 > lim[k]) ++k;
+      }
+      if (k == prev) continue;
+      if (prev <= b) emit(start, y, static_cast<i16>(x - start), alpha[prev]);
+      start = x;
+      prev = k;
     }
+  };
 
-    if (f >= 0) {
-      py--;
-      dd_f_y += 2;
-      f += dd_f_y;
+  for (i16 y = static_cast<i16>(ct - radius - b); y <= cb + radius + b; ++y) {
+    i32 dy = std::max({ct - y, y - cb, 0});
+    i32 y2 = dy * dy;
+    i16 py = static_cast<i16>(y - r.y());
+    if (py < 0 || py >= h) {
+      run(x_lo, x_hi, y, y2);
+      continue;
     }
-    px++;
-    dd_f_x += 2;
-    f += dd_f_x;
+    i16 in = 0;
+    if (inset && py < radius) in = inset[radius - py];
+    if (inset && py >= h - radius) in = inset[py - (h - 1 - radius)];
+    run(x_lo, std::min<i16>(x_hi, static_cast<i16>(r.x() + in)), y, y2);
+    run(std::max<i16>(x_lo, static_cast<i16>(r.right() - in)), x_hi, y, y2);
   }
 }
 
+template <painter P>
+void rounded_rect_gradient_v(P& p, rect r, i16 radius, u16 top_color,
+                             u16 bot_color, bool dither = false) {
+  detail::rounded_rect_gradient(p, r, radius, top_color, bot_color, dither,
+                                false);
+}
+
+template <painter P>
+void rounded_rect_gradient_v(P& p, rect r, i16 radius, const u16* rows) {
+  detail::rounded_rect_rows_colored(p, r, radius, rows, false);
+}
+
+template <painter P>
+void rounded_rect_gradient_v_aa(P& p, rect r, i16 radius, u16 top_color,
+                                u16 bot_color, bool dither = false) {
+  detail::rounded_rect_gradient(p, r, radius, top_color, bot_color, dither,
+                                true);
+}
+
+template <painter P>
+void rounded_rect_gradient_v_aa(P& p, rect r, i16 radius, const u16* rows) {
+  detail::rounded_rect_rows_colored(p, r, radius, rows, true);
+}
+
 template <painter P>
 void circle_outline(P& p, i16 x0, i16 y0, i16 r, u16 color) {
   i16 f = 1 - r;
@@ -178,57 +309,269 @@ void circle_outline(P& p, i16 x0, i16 y0, i16 r, u16 color) {
   }
 }
 
-template <painter P>
-void arc_fill(P& p, i16 cx, i16 cy, i16 outer_r, i16 inner_r, i16 start_deg,
-              i16 end_deg, u16 color) {
-  auto sin_approx = [](i16 deg) -> i32 {
-    deg = static_cast<i16>(((deg % 360) + 360) % 360);
-    bool neg = deg >= 180;
-    if (neg) deg = static_cast<i16>(deg - 180);
-    if (deg > 90) deg = static_cast<i16>(180 - deg);
-    i32 x = static_cast<i32>(deg) * 286 / 90;
-    i32 s = x * (512 - ((x * x) >> 8)) >> 8;
-    return neg ? -s : s;
+namespace detail {
+
+inline bool arc_below(i32 x, i32 y, i32 deg) {
+  if (x == 0 && y == 0) return 0 < deg;
+  i32 ax = x < 0 ? -x : x;
+  i32 ay = y < 0 ? -y : y;
+  auto angle_below = [&](i32 k) {
+    return ax > ay ? 45 * ay < k * ax : 45 * ax >= (91 - k) * ay;
   };
+  if (x < 0 && y <= 0) return !angle_below(181 - deg);
+  if (x < 0 && y > 0) return angle_below(deg - 180);
+  if (x >= 0 && y > 0) return !angle_below(361 - deg);
+  return angle_below(deg);
+}
+
+template <typename F>
+i16 arc_search(i16 lo, i16 hi, F&& pred) {
+  if (pred(lo)) return lo;
+  if (!pred(hi)) return static_cast<i16>(hi + 1);
+  while (hi - lo > 1) {
+    i16 mid = static_cast<i16>(lo + (hi - lo) / 2);
+    if (pred(mid))
+      hi = mid;
+    else
+      lo = mid;
+  }
+  return hi;
+}
 
-  auto cos_approx = [&](i16 deg) -> i32 {
-    return sin_approx(static_cast<i16>(deg + 90));
+template <typename F>
+void arc_spans(i16 y, i16 lo, i16 hi, i16 start_deg, i16 end_deg, F&& span) {
+  if (lo > hi) return;
+  auto emit = [&](i16 x0, i16 x1) {
+    if (x0 <= x1) span(x0, x1);
   };
+  bool wrap = start_deg > end_deg;
+  if (!wrap && start_deg <= 0 && end_deg >= 360) return span(lo, hi);
+  if (y <= 0) {
+    i16 a = arc_search(lo, hi,
+                       [&](i16 x) { return arc_below(x, y, start_deg); });
+    i16 b = arc_search(lo, hi,
+                       [&](i16 x) { return arc_below(x, y, end_deg + 1); });
+    if (!wrap) {
+      emit(b, static_cast<i16>(a - 1));
+    } else if (b <= a) {
+      emit(lo, hi);
+    } else {
+      emit(lo, static_cast<i16>(a - 1));
+      emit(b, hi);
+    }
+  } else {
+    i16 a = arc_search(lo, hi,
+                       [&](i16 x) { return !arc_below(x, y, start_deg); });
+    i16 b = arc_search(lo, hi,
+                       [&](i16 x) { return !arc_below(x, y, end_deg + 1); });
+    if (!wrap) {
+      emit(a, static_cast<i16>(b - 1));
+    } else if (a <= b) {
+      emit(lo, hi);
+    } else {
+      emit(lo, static_cast<i16>(b - 1));
+      emit(a, hi);
+    }
+  }
+}
 
+template <typename F>
+void arc_band(i16 y, i16 a, i16 b, i16 start_deg, i16 end_deg, F&& span) {
+  if (a > b) return;
+  if (a == 0) {
+    arc_spans(y, static_cast<i16>(-b), b, start_deg, end_deg, span);
+    return;
+  }
+  arc_spans(y, static_cast<i16>(-b), static_cast<i16>(-a), start_deg, end_deg,
+            span);
+  arc_spans(y, a, b, start_deg, end_deg, span);
+}
+
+template <typename Span, typename Edge>
+void arc_rows_aa(i16 outer_r, i16 inner_r, i16 start_deg, i16 end_deg,
+                 Span&& span, Edge&& edge) {
+  i32 or2 = static_cast<i32>(outer_r) * outer_r;
+  i32 oe2 = static_cast<i32>(outer_r + 1) * (outer_r + 1);
+  i32 ir2 = static_cast<i32>(inner_r) * inner_r;
+  i32 ie2 = static_cast<i32>(inner_r - 1) * (inner_r - 1);
+  u32 oscale = coverage_scale(2 * outer_r + 1);
+  u32 iscale = inner_r > 0 ? coverage_scale(2 * inner_r - 1) : 0;
+  i16 xe = -1;
+  i16 xs = -1;
+  i16 xie = -1;
+  i16 xis = -1;
   for (i16 y = static_cast<i16>(-outer_r); y <= outer_r; ++y) {
-    for (i16 x = static_cast<i16>(-outer_r); x <= outer_r; ++x) {
-      i32 d2 = static_cast<i32>(x) * x + static_cast<i32>(y) * y;
-      i32 or2 = static_cast<i32>(outer_r) * outer_r;
-      i32 ir2 = static_cast<i32>(inner_r) * inner_r;
-      if (d2 > or2 || d2 < ir2) continue;
-
-      i16 deg = 0;
-      if (x == 0 && y == 0)
-        deg = 0;
-      else {
-        i32 ax = x < 0 ? -x : x;
-        i32 ay = y < 0 ? -y : y;
-        i32 angle = (ax > ay) ? (ay * 45 / ax) : (90 - ax * 45 / ay);
-        if (x < 0 && y <= 0)
-          deg = static_cast<i16>(180 - angle);
-        else if (x < 0 && y > 0)
-          deg = static_cast<i16>(180 + angle);
-        else if (x >= 0 && y > 0)
-          deg = static_cast<i16>(360 - angle);
-        else
-          deg = static_cast<i16>(angle);
+    i32 y2 = static_cast<i32>(y) * y;
+    sqrt_track(xe, oe2 - 1 - y2);
+    sqrt_track(xs, or2 - y2);
+    sqrt_track(xie, inner_r > 0 ? ie2 - y2 : -1);
+    sqrt_track(xis, inner_r > 0 ? ir2 - y2 - 1 : -1);
+
+    auto solid = [&](i16 x0, i16 x1) { span(y, x0, x1); };
+    auto fringe = [&](i16 x0, i16 x1) {
+      for (i16 x = x0; x <= x1; ++x) {
+        i32 d2 = static_cast<i32>(x) * x + y2;
+        u8 a = coverage(oe2 - d2, oscale);
+        if (inner_r > 0) a = std::min(a, coverage(d2 - ie2, iscale));
+        if (a) edge(x, y, a);
       }
+    };
+
+    i16 b = static_cast<i16>(xis + 1);
+    arc_band(y, static_cast<i16>(xie + 1), xe, start_deg, end_deg,
+             [&](i16 x0, i16 x1) {
+               auto run = [&](i16 lo, i16 hi) {
+                 lo = std::max(lo, x0);
+                 hi = std::min(hi, x1);
+                 if (lo > hi) return;
+                 if (x0 < lo) fringe(x0, static_cast<i16>(lo - 1));
+                 solid(lo, hi);
+                 x0 = static_cast<i16>(hi + 1);
+               };
+               if (b == 0) {
+                 run(static_cast<i16>(-xs), xs);
+               } else if (b <= xs) {
+                 run(static_cast<i16>(-xs), static_cast<i16>(-b));
+                 run(b, xs);
+               }
+               if (x0 <= x1) fringe(x0, x1);
+             });
+  }
+}
 
-      bool in_range;
-      if (start_deg <= end_deg)
-        in_range = deg >= start_deg && deg <= end_deg;
-      else
-        in_range = deg >= start_deg || deg <= end_deg;
+}  // namespace detail
 
-      if (in_range) {
-        p.pixel(static_cast<i16>(cx + x), static_cast<i16>(cy + y), color);
-      }
+template <painter P>
+void arc_fill(P& p, i16 cx, i16 cy, i16 outer_r, i16 inner_r, i16 start_deg,
+              i16 end_deg, u16 color) {
+  i32 or2 = static_cast<i32>(outer_r) * outer_r;
+  i32 ir2 = static_cast<i32>(inner_r) * inner_r;
+  i16 xo = -1;
+  i16 xi = -1;
+  for (i16 y = static_cast<i16>(-outer_r); y <= outer_r; ++y) {
+    i32 y2 = static_cast<i32>(y) * y;
+    detail::sqrt_track(xo, or2 - y2);
+    detail::sqrt_track(xi, ir2 - y2 - 1);
+    detail::arc_band(y, static_cast<i16>(xi + 1), xo, start_deg, end_deg,
+                     [&](i16 x0, i16 x1) {
+                       p.hline(static_cast<i16>(cx + x0),
+                               static_cast<i16>(cy + y),
+                               static_cast<i16>(x1 - x0 + 1), color);
+                     });
+  }
+}
+
+template <painter P>
+void arc_fill_aa(P& p, i16 cx, i16 cy, i16 outer_r, i16 inner_r,
+                 i16 start_deg, i16 end_deg, u16 color) {
+  detail::arc_rows_aa(
+      outer_r, inner_r, start_deg, end_deg,
+      [&](i16 y, i16 x0, i16 x1) {
+        p.hline(static_cast<i16>(cx + x0), static_cast<i16>(cy + y),
+                static_cast<i16>(x1 - x0 + 1), color);
+      },
+      [&](i16 x, i16 y, u8 a) {
+        blend_pixel(p, static_cast<i16>(cx + x), static_cast<i16>(cy + y),
+                    color, a);
+      });
+}
+
+template <painter P>
+void arc_fill_aa(P& p, i16 cx, i16 cy, i16 outer_r, i16 inner_r,
+                 i16 start_deg, i16 end_deg, u16 color, u16 bg_color) {
+  detail::arc_rows_aa(
+      outer_r, inner_r, start_deg, end_deg,
+      [&](i16 y, i16 x0, i16 x1) {
+        p.hline(static_cast<i16>(cx + x0), static_cast<i16>(cy + y),
+                static_cast<i16>(x1 - x0 + 1), color);
+      },
+      [&](i16 x, i16 y, u8 a) {
+        p.pixel(static_cast<i16>(cx + x), static_cast<i16>(cy + y),
+                blend_rgb565(color, bg_color, a));
+      });
+}
+
+template <painter P>
+void fill_circle_aa(P& p, i16 cx, i16 cy, i16 r, u16 color) {
+  u32 scale = detail::coverage_scale(2 * r + 1);
+  i32 outer = static_cast<i32>(r + 1) * (r + 1);
+  detail::disc_rows(r, [&](i16 dy, i16 xs, i16 xe) {
+    i16 y = static_cast<i16>(cy + dy);
+    if (xs >= 0)
+      p.hline(static_cast<i16>(cx - xs), y, static_cast<i16>(2 * xs + 1),
+              color);
+    i32 y2 = static_cast<i32>(dy) * dy;
+    for (i16 dx = static_cast<i16>(xs + 1); dx <= xe; ++dx) {
+      u8 a = detail::coverage(outer - y2 - static_cast<i32>(dx) * dx, scale);
+      blend_pixel(p, static_cast<i16>(cx - dx), y, color, a);
+      blend_pixel(p, static_cast<i16>(cx + dx), y, color, a);
     }
+  });
+}
+
+template <painter P>
+void fill_circle_blend(P& p, i16 cx, i16 cy, i16 r, u16 color, u8 alpha) {
+  detail::disc_rows(r, [&](i16 dy, i16 xs, i16) {
+    if (xs >= 0)
+      hline_blend(p, static_cast<i16>(cx - xs), static_cast<i16>(cy + dy),
+                  static_cast<i16>(2 * xs + 1), color, alpha);
+  });
+}
+
+template <painter P>
+void fill_circle_blend_aa(P& p, i16 cx, i16 cy, i16 r, u16 color, u8 alpha) {
+  u32 scale = detail::coverage_scale(2 * r + 1);
+  i32 outer = static_cast<i32>(r + 1) * (r + 1);
+  detail::disc_rows(r, [&](i16 dy, i16 xs, i16 xe) {
+    i16 y = static_cast<i16>(cy + dy);
+    if (xs >= 0)
+      hline_blend(p, static_cast<i16>(cx - xs), y, static_cast<i16>(2 * xs + 1),
+                  color, alpha);
+    i32 y2 = static_cast<i32>(dy) * dy;
+    for (i16 dx = static_cast<i16>(xs + 1); dx <= xe; ++dx) {
+      u8 a = detail::coverage(outer - y2 - static_cast<i32>(dx) * dx, scale);
+      a = static_cast<u8>(div255(static_cast<u32>(a) * alpha));
+      hline_blend(p, static_cast<i16>(cx - dx), y, 1, color, a);
+      hline_blend(p, static_cast<i16>(cx + dx), y, 1, color, a);
+    }
+  });
+}
+
+template <painter P>
+void line_aa(P& p, i16 x0, i16 y0, i16 x1, i16 y1, u16 color) {
+  if (y0 == y1) {
+    p.hline(std::min(x0, x1), y0, static_cast<i16>(std::abs(x1 - x0) + 1),
+            color);
+    return;
+  }
+  if (x0 == x1) {
+    p.vline(x0, std::min(y0, y1), static_cast<i16>(std::abs(y1 - y0) + 1),
+            color);
+    return;
+  }
+  bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+  if (steep) {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  i32 step = (static_cast<i32>(y1 - y0) << 16) / (x1 - x0);
+  i32 fy = static_cast<i32>(y0) << 16;
+  auto plot = [&](i16 u, i32 v, u8 a) {
+    if (steep)
+      blend_pixel(p, static_cast<i16>(v), u, color, a);
+    else
+      blend_pixel(p, u, static_cast<i16>(v), color, a);
+  };
+  for (i16 x = x0; x <= x1; ++x) {
+    i32 y = fy >> 16;
+    u8 f = static_cast<u8>(fy >> 8);
+    plot(x, y, static_cast<u8>(255 - f));
+    if (f) plot(x, y + 1, f);
+    fy += step;
   }
 }
 
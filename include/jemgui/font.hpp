@@ -0,0 +1,48 @@
+#pragma once
+
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+struct font_glyph {
+  u32 offset;
+  u8 w;
+  u8 h;
+  i8 x;
+  i8 y;
+  u8 advance;
+};
+
+struct font {
+  const u8* bitmap;
+  const font_glyph* glyphs;
+  u8 first;
+  u8 last;
+  u8 bpp;
+  u8 line_height;
+  u8 baseline;
+};
+
+constexpr const font_glyph* find_glyph(const font& f, char c) {
+  u8 code = static_cast<u8>(c);
+  if (code < f.first || code > f.last) return nullptr;
+  return &f.glyphs[code - f.first];
+}
+
+constexpr u8 glyph_coverage(const font& f, const font_glyph& g, u32 i) {
+  u32 bit = i * f.bpp;
+  u8 byte = f.bitmap[g.offset + (bit >> 3)];
+  if (f.bpp == 1) return (byte >> (7 - (bit & 7))) & 1 ? 255 : 0;
+  return static_cast<u8>(((byte >> (6 - (bit & 7))) & 3) * 85);
+}
+
+constexpr i16 text_width(const font& f, const char* text) {
+  i16 w = 0;
+  for (; *text && *text != '\n'; ++text) {
+    const font_glyph* g = find_glyph(f, *text);
+    if (g) w = static_cast<i16>(w + g->advance);
+  }
+  return w;
+}
+
+}  // namespace jemgui
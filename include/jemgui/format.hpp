@@ -0,0 +1,333 @@
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+struct format_spec {
+  char fill = ' ';
+  char align = 0;
+  u8 width = 0;
+  i8 precision = -1;
+  char type = 0;
+};
+
+template <typename T>
+concept formattable = std::integral<std::remove_cvref_t<T>> ||
+                      std::floating_point<std::remove_cvref_t<T>> ||
+                      std::convertible_to<const T&, const char*>;
+
+namespace detail {
+
+void format_error(const char* msg);
+
+enum class arg_kind : u8 { sint, uint, flt, str, chr, boolean };
+
+struct format_arg {
+  arg_kind kind = arg_kind::sint;
+  union {
+    i64 i = 0;
+    u64 u;
+    float f;
+    const char* s;
+  };
+};
+
+template <formattable T>
+consteval arg_kind kind_of() {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (std::same_as<U, bool>)
+    return arg_kind::boolean;
+  else if constexpr (std::same_as<U, char>)
+    return arg_kind::chr;
+  else if constexpr (std::signed_integral<U>)
+    return arg_kind::sint;
+  else if constexpr (std::unsigned_integral<U>)
+    return arg_kind::uint;
+  else if constexpr (std::floating_point<U>)
+    return arg_kind::flt;
+  else
+    return arg_kind::str;
+}
+
+template <formattable T>
+constexpr format_arg make_arg(const T& v) {
+  format_arg a;
+  a.kind = kind_of<T>();
+  using U = std::remove_cvref_t<T>;
+  if constexpr (std::same_as<U, bool>)
+    a.u = v ? 1 : 0;
+  else if constexpr (std::same_as<U, char>)
+    a.u = static_cast<u8>(v);
+  else if constexpr (std::signed_integral<U>)
+    a.i = v;
+  else if constexpr (std::unsigned_integral<U>)
+    a.u = v;
+  else if constexpr (std::floating_point<U>)
+    a.f = static_cast<float>(v);
+  else
+    a.s = v;
+  return a;
+}
+
+constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr bool is_align(char c) { return c == '<' || c == '>' || c == '^'; }
+
+constexpr bool parse_spec(const char*& p, format_spec& spec) {
+  spec = {};
+  if (*p == ':') {
+    ++p;
+    if (*p && *p != '}' && is_align(p[1])) {
+      spec.fill = p[0];
+      spec.align = p[1];
+      p += 2;
+    } else if (is_align(*p)) {
+      spec.align = *p++;
+    }
+    if (*p == '0' && !spec.align) {
+      spec.fill = '0';
+      spec.align = '=';
+      ++p;
+    }
+    u32 w = 0;
+    while (is_digit(*p)) {
+      w = w * 10 + static_cast<u32>(*p++ - '0');
+      if (w > 255) return false;
+    }
+    spec.width = static_cast<u8>(w);
+    if (*p == '.') {
+      ++p;
+      if (!is_digit(*p) || is_digit(p[1]) || *p > '6') return false;
+      spec.precision = static_cast<i8>(*p++ - '0');
+    }
+    if (*p == 'd' || *p == 'x' || *p == 'X' || *p == 's' || *p == 'c')
+      spec.type = *p++;
+  }
+  if (*p != '}') return false;
+  ++p;
+  return true;
+}
+
+constexpr bool spec_fits(const format_spec& spec, arg_kind kind) {
+  bool number = spec.type == 0 || spec.type == 'd' || spec.type == 'x' ||
+                spec.type == 'X';
+  switch (kind) {
+    case arg_kind::sint:
+    case arg_kind::uint:
+      return number && (spec.precision < 0 || spec.type == 0 ||
+                        spec.type == 'd');
+    case arg_kind::flt:
+      return spec.type == 0;
+    case arg_kind::chr:
+      return spec.precision < 0 &&
+             (spec.type == 'c' || (spec.type != 0 && number) ||
+              (spec.type == 0 && spec.align != '='));
+    case arg_kind::str:
+    case arg_kind::boolean:
+      return (spec.type == 0 || spec.type == 's') && spec.precision < 0 &&
+             spec.align != '=';
+  }
+  return false;
+}
+
+constexpr void check_format(const char* p, const arg_kind* kinds, usize n) {
+  usize next = 0;
+  while (*p) {
+    if (*p == '}') {
+      if (p[1] != '}') format_error("unmatched '}' in format string");
+      p += 2;
+      continue;
+    }
+    if (*p++ != '{') continue;
+    if (*p == '{') {
+      ++p;
+      continue;
+    }
+    format_spec spec;
+    if (!parse_spec(p, spec)) format_error("malformed format spec");
+    if (next >= n) format_error("more fields than arguments");
+    if (!spec_fits(spec, kinds[next]))
+      format_error("format spec does not fit the argument type");
+    ++next;
+  }
+  if (next != n) format_error("more arguments than fields");
+}
+
+struct format_sink {
+  char* out;
+  usize cap;
+  usize n = 0;
+
+  constexpr void put(char c) {
+    if (n + 1 < cap) out[n++] = c;
+  }
+  constexpr void put(const char* s, usize len) {
+    while (len--) put(*s++);
+  }
+  constexpr void fill(char c, usize count) {
+    while (count--) put(c);
+  }
+};
+
+constexpr char* put_digits(char* end, u64 v, bool hex, bool upper) {
+  const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  if (hex) {
+    do {
+      *--end = digits[v & 15];
+      v >>= 4;
+    } while (v);
+    return end;
+  }
+  while (v > 0xFFFFFFFFu) {
+    *--end = static_cast<char>('0' + v % 10);
+    v /= 10;
+  }
+  u32 w = static_cast<u32>(v);
+  do {
+    *--end = static_cast<char>('0' + w % 10);
+    w /= 10;
+  } while (w);
+  return end;
+}
+
+constexpr char* put_fixed(char* end, u64 v, i8 frac) {
+  if (frac <= 0) return put_digits(end, v, false, false);
+  for (i8 i = 0; i < frac; ++i) {
+    *--end = static_cast<char>('0' + v % 10);
+    v /= 10;
+  }
+  *--end = '.';
+  return put_digits(end, v, false, false);
+}
+
+constexpr usize length(const char* s) {
+  usize n = 0;
+  while (s[n]) ++n;
+  return n;
+}
+
+constexpr void put_field(format_sink& sink, const format_spec& spec,
+                         const char* s, usize len, char def_align,
+                         bool sign) {
+  usize pad = spec.width > len ? spec.width - len : 0;
+  char align = spec.align ? spec.align : def_align;
+  if (align == '=') {
+    if (sign) {
+      sink.put(*s++);
+      --len;
+    }
+    sink.fill('0', pad);
+    sink.put(s, len);
+    return;
+  }
+  usize left = align == '>' ? pad : align == '^' ? pad / 2 : 0;
+  sink.fill(spec.fill, left);
+  sink.put(s, len);
+  sink.fill(spec.fill, pad - left);
+}
+
+constexpr void put_arg(format_sink& sink, const format_spec& spec,
+                       const format_arg& a) {
+  constexpr float scale[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f};
+  char tmp[32];
+  char* end = tmp + sizeof(tmp);
+  char* b = end;
+  bool neg = false;
+  bool hex = spec.type == 'x' || spec.type == 'X';
+  bool upper = spec.type == 'X';
+  switch (a.kind) {
+    case arg_kind::sint: {
+      neg = a.i < 0;
+      u64 m = neg ? u64{0} - static_cast<u64>(a.i) : static_cast<u64>(a.i);
+      b = hex ? put_digits(end, m, true, upper)
+              : put_fixed(end, m, spec.precision);
+      break;
+    }
+    case arg_kind::uint:
+      b = hex ? put_digits(end, a.u, true, upper)
+              : put_fixed(end, a.u, spec.precision);
+      break;
+    case arg_kind::flt: {
+      i8 prec = spec.precision < 0 ? 2 : spec.precision;
+      neg = a.f < 0;
+      float x = (neg ? -a.f : a.f) * scale[prec] + 0.5f;
+      if (a.f != a.f) return put_field(sink, spec, "nan", 3, '>', false);
+      if (!(x < 1.8e19f))
+        return put_field(sink, spec, neg ? "-inf" : "inf", neg ? 4 : 3, '>',
+                         neg);
+      b = put_fixed(end, static_cast<u64>(x), prec);
+      break;
+    }
+    case arg_kind::chr:
+      if (spec.type == 0 || spec.type == 'c') {
+        *--b = static_cast<char>(a.u);
+        return put_field(sink, spec, b, 1, '<', false);
+      }
+      b = put_digits(end, a.u, hex, upper);
+      break;
+    case arg_kind::str:
+      return put_field(sink, spec, a.s, length(a.s), '<', false);
+    case arg_kind::boolean:
+      return put_field(sink, spec, a.u ? "true" : "false", a.u ? 4 : 5, '<',
+                       false);
+  }
+  if (neg) *--b = '-';
+  put_field(sink, spec, b, static_cast<usize>(end - b), '>', neg);
+}
+
+constexpr usize vformat(char* out, usize cap, const char* p,
+                        const format_arg* args) {
+  format_sink sink{out, cap};
+  while (*p) {
+    char c = *p++;
+    if (c == '}') {
+      ++p;
+    } else if (c == '{' && *p != '{') {
+      format_spec spec;
+      parse_spec(p, spec);
+      put_arg(sink, spec, *args++);
+      continue;
+    } else if (c == '{') {
+      ++p;
+    }
+    sink.put(c);
+  }
+  if (cap) out[sink.n] = 0;
+  return sink.n;
+}
+
+}  // namespace detail
+
+template <formattable... Args>
+class format_string {
+ public:
+  consteval format_string(const char* str) : str_{str} {
+    detail::arg_kind kinds[sizeof...(Args) + 1] = {detail::kind_of<Args>()...};
+    detail::check_format(str_, kinds, sizeof...(Args));
+  }
+
+  constexpr const char* get() const { return str_; }
+
+ private:
+  const char* str_;
+};
+
+template <formattable... Args>
+constexpr usize format_to(char* out, usize cap,
+                          format_string<std::type_identity_t<Args>...> fmt,
+                          const Args&... args) {
+  detail::format_arg list[sizeof...(Args) + 1] = {detail::make_arg(args)...};
+  return detail::vformat(out, cap, fmt.get(), list);
+}
+
+template <usize N, formattable... Args>
+constexpr usize format_to(char (&out)[N],
+                          format_string<std::type_identity_t<Args>...> fmt,
+                          const Args&... args) {
+  return format_to(out, N, fmt, args...);
+}
+
+}  // namespace jemgui
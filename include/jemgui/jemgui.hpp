@@ -4,11 +4,18 @@
 #include <jemgui/canvas.hpp>
 #include <jemgui/color.hpp>
 #include <jemgui/context.hpp>
+#include <jemgui/display_list.hpp>
 #include <jemgui/draw.hpp>
+#include <jemgui/font.hpp>
+#include <jemgui/format.hpp>
 #include <jemgui/hash.hpp>
 #include <jemgui/input.hpp>
 #include <jemgui/layout.hpp>
 #include <jemgui/painter.hpp>
+#include <jemgui/plot.hpp>
+#include <jemgui/state_table.hpp>
+#include <jemgui/stats.hpp>
+#include <jemgui/strip_canvas.hpp>
 #include <jemgui/theme.hpp>
 #include <jemgui/types.hpp>
 #include <jemgui/widgets.hpp>
@@ -12,6 +12,12 @@ struct container {
   direction dir = direction::vertical;
   i16 spacing = 0;
   i16 child_count = 0;
+  bool culled = false;
+};
+
+struct table_column {
+  const char* title = nullptr;
+  i16 width = 0;
 };
 
 struct layout_stack {
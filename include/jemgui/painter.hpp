@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <jemgui/font.hpp>
 #include <jemgui/types.hpp>
 
 namespace jemgui {
@@ -23,4 +24,28 @@ concept painter = requires(P p, i16 x, i16 y, i16 w, i16 h, u16 color,
   { p.clear_clip() } -> std::same_as<void>;
 };
 
+template <typename P>
+concept font_painter = painter<P> && requires(P p, const font* f) {
+  { p.set_font(f) } -> std::same_as<void>;
+  { p.text_font() } -> std::convertible_to<const font*>;
+};
+
+template <typename P>
+concept readable_painter = painter<P> && requires(const P p, i16 x, i16 y) {
+  { p.read_pixel(x, y) } -> std::convertible_to<u16>;
+};
+
+template <typename P>
+concept blend_painter =
+    painter<P> && requires(P p, i16 x, i16 y, i16 w, i16 h, u16 color, u8 a) {
+      { p.hline_blend(x, y, w, color, a) } -> std::same_as<void>;
+      { p.fill_rect_blend(x, y, w, h, color, a) } -> std::same_as<void>;
+    };
+
+template <typename P>
+concept scroll_painter =
+    painter<P> && requires(P p, rect r, i16 dx, i16 dy) {
+      { p.scroll_region(r, dx, dy) } -> std::same_as<void>;
+    };
+
 }  // namespace jemgui
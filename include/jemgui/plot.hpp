@@ -0,0 +1,243 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <jemgui/painter.hpp>
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+struct series {
+  const i16* data = nullptr;
+  u32 capacity = 0;
+  u32 head = 0;
+  u32 total = 0;
+
+  u32 count() const { return total < capacity ? total : capacity; }
+  u32 oldest() const { return total - count(); }
+};
+
+template <usize N>
+class sample_ring {
+ public:
+  void push(i16 v) {
+    data_[head_] = v;
+    if (++head_ == N) head_ = 0;
+    ++total_;
+  }
+
+  void clear() {
+    head_ = 0;
+    total_ = 0;
+  }
+
+  u32 total() const { return total_; }
+  u32 count() const { return total_ < N ? total_ : static_cast<u32>(N); }
+  series view() const { return {data_, static_cast<u32>(N), head_, total_}; }
+  operator series() const { return view(); }
+
+ private:
+  i16 data_[N] = {};
+  u32 head_ = 0;
+  u32 total_ = 0;
+};
+
+struct sample_span {
+  i16 lo = std::numeric_limits<i16>::max();
+  i16 hi = std::numeric_limits<i16>::min();
+
+  bool empty() const { return lo > hi; }
+};
+
+namespace draw {
+
+class series_reader {
+ public:
+  series_reader(const series& s, u32 at) : s_{s}, at_{at} {
+    u32 back = s.total - at;
+    pos_ = s.head >= back ? s.head - back : s.head + s.capacity - back;
+  }
+
+  void seek(u32 at) {
+    pos_ += at - at_;
+    while (pos_ >= s_.capacity) pos_ -= s_.capacity;
+    at_ = at;
+  }
+
+  sample_span scan(u32 n) const {
+    i16 lo = std::numeric_limits<i16>::max();
+    i16 hi = std::numeric_limits<i16>::min();
+    u32 pos = pos_;
+    while (n > 0) {
+      u32 run = std::min(n, s_.capacity - pos);
+      const i16* p = s_.data + pos;
+      for (u32 i = 0; i < run; ++i) {
+        lo = std::min(lo, p[i]);
+        hi = std::max(hi, p[i]);
+      }
+      n -= run;
+      pos = 0;
+    }
+    return {lo, hi};
+  }
+
+ private:
+  const series& s_;
+  u32 at_;
+  u32 pos_;
+};
+
+inline sample_span series_bounds(const series& s) {
+  if (s.count() == 0) return {};
+  return series_reader{s, s.oldest()}.scan(s.count());
+}
+
+class fit_columns {
+ public:
+  fit_columns(const series& s, u16 cols)
+      : reader_{s, s.oldest()},
+        at_{s.oldest()},
+        n_{s.count()},
+        step_{cols ? n_ / cols : 0},
+        rem_{cols ? n_ % cols : 0},
+        cols_{cols} {}
+
+  sample_span next() {
+    if (n_ == 0) return {};
+    u32 len = step_;
+    err_ += rem_;
+    if (err_ >= cols_) {
+      err_ -= cols_;
+      ++len;
+    }
+    sample_span r = reader_.scan(len ? len : 1);
+    at_ += len;
+    reader_.seek(at_);
+    return r;
+  }
+
+ private:
+  series_reader reader_;
+  u32 at_;
+  u32 n_;
+  u32 step_;
+  u32 rem_;
+  u32 cols_;
+  u32 err_ = 0;
+};
+
+class strip_columns {
+ public:
+  strip_columns(const series& s, i64 first, u16 per_col)
+      : reader_{s, clamp(s, first)},
+        oldest_{s.oldest()},
+        total_{s.total},
+        at_{first},
+        per_col_{per_col} {}
+
+  sample_span next() {
+    i64 from = std::max<i64>(at_, oldest_);
+    i64 to = std::min<i64>(at_ + per_col_, total_);
+    at_ += per_col_;
+    if (from >= to) return {};
+    reader_.seek(static_cast<u32>(from));
+    return reader_.scan(static_cast<u32>(to - from));
+  }
+
+ private:
+  static u32 clamp(const series& s, i64 at) {
+    return static_cast<u32>(std::clamp<i64>(at, s.oldest(), s.total));
+  }
+
+  series_reader reader_;
+  i64 oldest_;
+  i64 total_;
+  i64 at_;
+  i64 per_col_;
+};
+
+class plot_scale {
+ public:
+  plot_scale(rect r, i16 lo, i16 hi)
+      : lo_{lo},
+        hi_{hi},
+        bottom_{static_cast<i16>(r.bottom() - 1)},
+        scale_{(static_cast<u32>(r.h() - 1) << 16) /
+               static_cast<u32>(static_cast<i32>(hi) - lo)} {}
+
+  i16 y(i16 v) const {
+    v = std::clamp(v, lo_, hi_);
+    u32 d = static_cast<u32>(static_cast<i32>(v) - lo_);
+    return static_cast<i16>(bottom_ - static_cast<i16>((d * scale_) >> 16));
+  }
+
+ private:
+  i16 lo_;
+  i16 hi_;
+  i16 bottom_;
+  u32 scale_;
+};
+
+template <painter P, typename Columns>
+void plot_columns(P& p, rect r, i16 from, i16 to, const plot_scale& sc,
+                  sample_span prev, Columns& cols, u16 color, u16 bg) {
+  for (i16 i = from; i < to; ++i) {
+    i16 x = static_cast<i16>(r.x() + i);
+    sample_span s = cols.next();
+    if (s.empty()) {
+      p.vline(x, r.y(), static_cast<i16>(r.h()), bg);
+      prev = s;
+      continue;
+    }
+    i16 lo = s.lo;
+    i16 hi = s.hi;
+    if (!prev.empty()) {
+      lo = std::min(lo, prev.hi);
+      hi = std::max(hi, prev.lo);
+    }
+    i16 top = sc.y(hi);
+    i16 bot = sc.y(lo);
+    p.vline(x, r.y(), static_cast<i16>(top - r.y()), bg);
+    p.vline(x, top, static_cast<i16>(bot - top + 1), color);
+    p.vline(x, static_cast<i16>(bot + 1),
+            static_cast<i16>(r.bottom() - 1 - bot), bg);
+    prev = s;
+  }
+}
+
+template <painter P>
+void plot_fit(P& p, rect r, const series& s, i16 lo, i16 hi, u16 color,
+              u16 bg) {
+  if (r.w() == 0 || r.h() == 0 || hi <= lo) return;
+  fit_columns cols{s, r.w()};
+  plot_columns(p, r, 0, static_cast<i16>(r.w()), plot_scale{r, lo, hi}, {},
+               cols, color, bg);
+}
+
+inline u32 strip_column(const series& s, u16 per_col) {
+  return s.total ? (s.total - 1) / per_col : 0;
+}
+
+template <painter P>
+void plot_strip(P& p, rect r, const series& s, u16 per_col, i16 lo, i16 hi,
+                u16 color, u16 bg, i16 from, i16 to) {
+  if (r.w() == 0 || r.h() == 0 || hi <= lo || per_col == 0) return;
+  from = std::max<i16>(from, 0);
+  to = std::min<i16>(to, static_cast<i16>(r.w()));
+  if (from >= to) return;
+  i64 before = static_cast<i64>(strip_column(s, per_col)) - r.w() + from;
+  strip_columns cols{s, before * per_col, per_col};
+  sample_span prev = cols.next();
+  plot_columns(p, r, from, to, plot_scale{r, lo, hi}, prev, cols, color, bg);
+}
+
+template <painter P>
+void plot_strip(P& p, rect r, const series& s, u16 per_col, i16 lo, i16 hi,
+                u16 color, u16 bg) {
+  plot_strip(p, r, s, per_col, lo, hi, color, bg, 0,
+             static_cast<i16>(r.w()));
+}
+
+}  // namespace draw
+
+}  // namespace jemgui
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+template <typename Key, typename Value, usize N, u32 Keep = 2>
+class state_table {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of 2");
+
+  enum class slot_state : u8 { empty, used, dead };
+
+  struct slot {
+    Key key = {};
+    Value value = {};
+    u32 touched = 0;
+    slot_state state = slot_state::empty;
+  };
+
+ public:
+  static constexpr usize capacity = N;
+
+  template <typename S, typename V>
+  class basic_iterator {
+   public:
+    V& operator*() const { return s_->value; }
+    V* operator->() const { return &s_->value; }
+    basic_iterator& operator++() {
+      ++s_;
+      skip();
+      return *this;
+    }
+    bool operator!=(const basic_iterator& o) const { return s_ != o.s_; }
+
+   private:
+    friend class state_table;
+    basic_iterator(S* s, S* end) : s_{s}, end_{end} { skip(); }
+    void skip() {
+      while (s_ != end_ && s_->state != slot_state::used) ++s_;
+    }
+
+    S* s_;
+    S* end_;
+  };
+
+  using iterator = basic_iterator<slot, Value>;
+  using const_iterator = basic_iterator<const slot, const Value>;
+
+  iterator begin() { return {slots_, slots_ + N}; }
+  iterator end() { return {slots_ + N, slots_ + N}; }
+  const_iterator begin() const { return {slots_, slots_ + N}; }
+  const_iterator end() const { return {slots_ + N, slots_ + N}; }
+
+  void tick() { ++gen_; }
+  u32 generation() const { return gen_; }
+  usize size() const { return size_; }
+
+  Value* find(Key key) {
+    slot* s = lookup(*this, key);
+    return s ? &s->value : nullptr;
+  }
+
+  const Value* find(Key key) const {
+    const slot* s = lookup(*this, key);
+    return s ? &s->value : nullptr;
+  }
+
+  Value* get(Key key) {
+    return get(key, [](const Value&) {});
+  }
+
+  template <typename OnEvict>
+  Value* get(Key key, OnEvict&& on_evict) {
+    usize i = home(key);
+    slot* free = nullptr;
+    for (usize n = 0; n < N; ++n, i = (i + 1) & (N - 1)) {
+      slot& s = slots_[i];
+      if (s.state == slot_state::used && s.key == key) {
+        s.touched = gen_;
+        return &s.value;
+      }
+      if (s.state != slot_state::used && !free) free = &s;
+      if (s.state == slot_state::empty) break;
+    }
+    if (!free) free = stalest();
+    if (!free) return nullptr;
+    if (free->state == slot_state::used)
+      on_evict(free->value);
+    else
+      ++size_;
+    *free = {key, {}, gen_, slot_state::used};
+    return &free->value;
+  }
+
+  bool erase(Key key) {
+    slot* s = lookup(*this, key);
+    if (!s) return false;
+    s->value = {};
+    s->state = slot_state::dead;
+    --size_;
+    return true;
+  }
+
+  void clear() {
+    for (slot& s : slots_) s = {};
+    size_ = 0;
+  }
+
+ private:
+  static usize home(Key key) {
+    return static_cast<usize>((static_cast<u32>(key) * 2654435761u) >> 16) &
+           (N - 1);
+  }
+
+  template <typename T>
+  static auto lookup(T& t, Key key) -> decltype(&t.slots_[0]) {
+    usize i = home(key);
+    for (usize n = 0; n < N; ++n, i = (i + 1) & (N - 1)) {
+      auto& s = t.slots_[i];
+      if (s.state == slot_state::empty) return nullptr;
+      if (s.state == slot_state::used && s.key == key) return &s;
+    }
+    return nullptr;
+  }
+
+  slot* stalest() {
+    slot* best = nullptr;
+    for (slot& s : slots_) {
+      if (gen_ - s.touched < Keep) continue;
+      if (!best || gen_ - s.touched > gen_ - best->touched) best = &s;
+    }
+    return best;
+  }
+
+  slot slots_[N] = {};
+  u32 gen_ = 0;
+  usize size_ = 0;
+};
+
+}  // namespace jemgui
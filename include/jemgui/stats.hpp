@@ -0,0 +1,53 @@
+#pragma once
+
+#include <jemgui/types.hpp>
+
+#ifndef JEMGUI_STATS
+#define JEMGUI_STATS 0
+#endif
+
+#if JEMGUI_STATS
+#define JEMGUI_STAT(expr) (expr)
+#else
+#define JEMGUI_STAT(expr) ((void)0)
+#endif
+
+namespace jemgui {
+
+using stats_clock = u32 (*)();
+
+struct prim_stats {
+  u32 calls = 0;
+  u32 px = 0;
+};
+
+struct paint_stats {
+  prim_stats fill_rect;
+  prim_stats hline;
+  prim_stats vline;
+  prim_stats pixel;
+  prim_stats circle;
+  prim_stats glyph;
+  u32 clip_rejects = 0;
+  u32 dirty_rects = 0;
+  u32 dirty_px = 0;
+  u32 flush_cycles = 0;
+
+  u32 total_px() const {
+    return fill_rect.px + hline.px + vline.px + pixel.px + circle.px +
+           glyph.px;
+  }
+};
+
+struct frame_stats {
+  paint_stats paint;
+  u32 widgets = 0;
+  u32 culled = 0;
+  u32 anims_active = 0;
+  u32 text_misses = 0;
+  u32 begin_cycles = 0;
+  u32 widget_cycles = 0;
+  u32 end_cycles = 0;
+};
+
+}  // namespace jemgui
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <jemgui/canvas.hpp>
+#include <jemgui/display_list.hpp>
+#include <jemgui/types.hpp>
+
+namespace jemgui {
+
+#define JEMGUI_STRIPBUF(name, max_w, strip_h) \
+  static u16 name[(max_w) * (strip_h)]
+
+template <typename D, u16 StripH, usize Capacity = 16384>
+class strip_canvas {
+ public:
+  strip_canvas(D& display, u16* buf, u16* back_buf = nullptr)
+      : display_{display},
+        w_{display.width()},
+        h_{display.height()},
+        port_{&display, 0, w_, h_},
+        bufs_{buf, back_buf ? back_buf : buf},
+        strips_{{port_, bufs_[0]}, {port_, bufs_[1]}},
+        list_{w_, h_} {}
+
+  u16 width() const { return w_; }
+  u16 height() const { return h_; }
+
+  void reinit() {
+    port_.wait();
+    w_ = display_.width();
+    h_ = display_.height();
+    port_.w = w_;
+    port_.total_h = h_;
+    strips_[0].reinit();
+    strips_[1].reinit();
+    list_.resize(w_, h_);
+    list_.clear_clip();
+    list_.clear();
+  }
+
+  bool overflowed() const { return list_.overflowed(); }
+  usize bytes_used() const { return list_.bytes_used(); }
+  const display_list<Capacity>& commands() const { return list_; }
+
+  void set_clip(rect r) { list_.set_clip(r); }
+  void clear_clip() { list_.clear_clip(); }
+
+  void fill_screen(u16 color) {
+    bg_ = color;
+    list_.clear();
+  }
+
+  void pixel(i16 x, i16 y, u16 color) { list_.pixel(x, y, color); }
+
+  void hline(i16 x, i16 y, i16 length, u16 color) {
+    list_.hline(x, y, length, color);
+  }
+
+  void vline(i16 x, i16 y, i16 vh, u16 color) { list_.vline(x, y, vh, color); }
+
+  void fill_rect(i16 x, i16 y, i16 w, i16 h, u16 color) {
+    list_.fill_rect(x, y, w, h, color);
+  }
+
+  void hline_blend(i16 x, i16 y, i16 length, u16 color, u8 alpha) {
+    list_.hline_blend(x, y, length, color, alpha);
+  }
+
+  void fill_rect_blend(i16 x, i16 y, i16 w, i16 h, u16 color, u8 alpha) {
+    list_.fill_rect_blend(x, y, w, h, color, alpha);
+  }
+
+  void fill_circle(i16 x0, i16 y0, i16 r, u16 color) {
+    list_.fill_circle(x0, y0, r, color);
+  }
+
+  void set_cursor(i16 x, i16 y) { list_.set_cursor(x, y); }
+  void set_text_color(u16 c) { list_.set_text_color(c); }
+  void set_text_size(u8 s) { list_.set_text_size(s); }
+  void print(const char* str) { list_.print(str); }
+
+  void flush() {
+    usize n = 0;
+    for (u16 y0 = 0; y0 < h_; y0 = static_cast<u16>(y0 + StripH), ++n) {
+      auto& s = strips_[n & 1];
+      if (bufs_[n & 1] == sent_) port_.wait();
+      port_.y0 = y0;
+      s.clear_clip();
+      s.fill_screen(bg_);
+      list_.replay(s, rect{{0, static_cast<i16>(y0)}, {w_, StripH}});
+      s.clear_clip();
+      s.flush();
+      sent_ = bufs_[n & 1];
+    }
+    list_.clear();
+  }
+
+  void wait() { port_.wait(); }
+
+ private:
+  struct strip_port {
+    D* display;
+    u16 y0;
+    u16 w;
+    u16 total_h;
+
+    u16 width() const { return w; }
+    u16 height() const { return StripH; }
+
+    u16 rows(u16 y, u16 h) const {
+      u16 top = static_cast<u16>(y0 + y);
+      if (top >= total_h) return 0;
+      return std::min<u16>(h, static_cast<u16>(total_h - top));
+    }
+
+    void wait() {
+      if constexpr (async_display<D>) {
+        while (display->is_busy()) {
+        }
+      }
+    }
+
+    void blit(u16 x, u16 y, u16 bw, u16 bh, const u16* data) {
+      bh = rows(y, bh);
+      if (bh == 0) return;
+      u16 top = static_cast<u16>(y0 + y);
+      if constexpr (async_display<D>) {
+        wait();
+        display->blit_async(x, top, bw, bh, data);
+      } else {
+        display->blit(x, top, bw, bh, data);
+      }
+    }
+
+    void blit(u16 x, u16 y, u16 bw, u16 bh, const u16* data, u16 stride)
+      requires requires(D& d) { d.blit(x, y, bw, bh, data, stride); }
+    {
+      bh = rows(y, bh);
+      if (bh == 0) return;
+      u16 top = static_cast<u16>(y0 + y);
+      if constexpr (requires(D& d) {
+                      d.blit_async(x, y, bw, bh, data, stride);
+                      d.is_busy();
+                    }) {
+        wait();
+        display->blit_async(x, top, bw, bh, data, stride);
+      } else {
+        display->blit(x, top, bw, bh, data, stride);
+      }
+    }
+  };
+
+  D& display_;
+  u16 w_;
+  u16 h_;
+  strip_port port_;
+  u16* bufs_[2];
+  const u16* sent_ = nullptr;
+  canvas<strip_port> strips_[2];
+  display_list<Capacity> list_;
+  u16 bg_ = 0x0000;
+};
+
+}  // namespace jemgui
@@ -26,6 +26,8 @@ struct theme {
   i16 widget_height;
   i16 border_width;
   u8 font_size;
+  bool antialias = true;
+  bool dither = false;
 };
 
 namespace themes {
@@ -94,6 +96,7 @@ inline constexpr theme mono = {
     .widget_height = 12,
     .border_width = 1,
     .font_size = 1,
+    .antialias = false,
 };
 
 }  // namespace themes
@@ -60,6 +60,21 @@ struct rect {
     return p.x >= pos.x && p.x < right() && p.y >= pos.y && p.y < bottom();
   }
 
+  constexpr bool overlaps(const rect& o) const {
+    return pos.x < o.right() && o.pos.x < right() && pos.y < o.bottom() &&
+           o.pos.y < bottom();
+  }
+
+  constexpr rect intersect(const rect& o) const {
+    i16 x0 = pos.x > o.pos.x ? pos.x : o.pos.x;
+    i16 y0 = pos.y > o.pos.y ? pos.y : o.pos.y;
+    i16 x1 = right() < o.right() ? right() : o.right();
+    i16 y1 = bottom() < o.bottom() ? bottom() : o.bottom();
+    if (x1 <= x0 || y1 <= y0) return {{x0, y0}, {0, 0}};
+    return {{x0, y0},
+            {static_cast<u16>(x1 - x0), static_cast<u16>(y1 - y0)}};
+  }
+
   constexpr rect shrink(i16 amount) const {
     return {
         {static_cast<i16>(pos.x + amount), static_cast<i16>(pos.y + amount)},
@@ -7,6 +7,132 @@
 
 namespace jemgui::draw {
 
+inline constexpr i16 corner_table_radius = 32;
+
+struct corner_table {
+  u8 inset[(corner_table_radius + 1) * (corner_table_radius + 2) / 2] = {};
+
+  static constexpr void build(i16 radius, u8* inset) {
+    for (i16 d = 0; d <= radius; ++d) inset[d] = static_cast<u8>(radius);
+    i16 f = static_cast<i16>(1 - radius);
+    i16 dd_f_y = static_cast<i16>(-2 * radius);
+    i16 px = 0;
+    i16 py = radius;
+    while (px <= py) {
+      inset[py] = static_cast<u8>(std::min<i16>(inset[py], radius - px));
+      inset[px] = static_cast<u8>(std::min<i16>(inset[px], radius - py));
+      if (f >= 0) {
+        py--;
+        dd_f_y = static_cast<i16>(dd_f_y + 2);
+        f = static_cast<i16>(f + dd_f_y);
+      }
+      px++;
+      f = static_cast<i16>(f + 2 * px + 1);
+    }
+  }
+
+  constexpr corner_table() {
+    for (i16 radius = 1; radius <= corner_table_radius; ++radius)
+      build(radius, inset + radius * (radius + 1) / 2);
+  }
+
+  constexpr const u8* get(i16 radius) const {
+    return inset + radius * (radius + 1) / 2;
+  }
+};
+
+inline constexpr corner_table corners;
+
+inline const u8* corner_insets(i16 radius, u8 (&scratch)[256]) {
+  if (radius <= corner_table_radius) return corners.get(radius);
+  corner_table::build(radius, scratch);
+  return scratch;
+}
+
+namespace detail {
+
+inline void sqrt_track(i16& x, i32 rem) {
+  while (static_cast<i32>(x + 1) * (x + 1) <= rem) ++x;
+  while (x >= 0 && static_cast<i32>(x) * x > rem) --x;
+}
+
+inline u32 coverage_scale(i32 span) {
+  return (u32{255} << 16) / static_cast<u32>(span);
+}
+
+inline u8 coverage(i32 num, u32 scale) {
+  if (num <= 0) return 0;
+  return static_cast<u8>(
+      std::min<u32>((static_cast<u32>(num) * scale) >> 16, 255));
+}
+
+template <typename F>
+void disc_rows(i16 radius, F&& row) {
+  i32 r2 = static_cast<i32>(radius) * radius;
+  i32 e2 = static_cast<i32>(radius + 1) * (radius + 1) - 1;
+  i16 xs = -1;
+  i16 xe = -1;
+  for (i16 dy = static_cast<i16>(-radius); dy <= radius; ++dy) {
+    i32 y2 = static_cast<i32>(dy) * dy;
+    sqrt_track(xs, r2 - y2);
+    sqrt_track(xe, e2 - y2);
+    row(dy, xs, xe);
+  }
+}
+
+}  // namespace detail
+
+template <painter P>
+void blend_pixel(P& p, i16 x, i16 y, u16 color, u8 alpha) {
+  if (alpha == 255) {
+    p.pixel(x, y, color);
+  } else if constexpr (readable_painter<P>) {
+    if (alpha) p.pixel(x, y, blend_rgb565(color, p.read_pixel(x, y), alpha));
+  } else if (alpha >= 128) {
+    p.pixel(x, y, color);
+  }
+}
+
+template <painter P>
+void hline_blend(P& p, i16 x, i16 y, i16 w, u16 color, u8 alpha) {
+  if constexpr (blend_painter<P>) {
+    p.hline_blend(x, y, w, color, alpha);
+  } else if constexpr (readable_painter<P>) {
+    for (i16 i = 0; i < w; ++i)
+      blend_pixel(p, static_cast<i16>(x + i), y, color, alpha);
+  } else if (alpha >= 128) {
+    p.hline(x, y, w, color);
+  }
+}
+
+template <painter P>
+void fill_rect_blend(P& p, rect r, u16 color, u8 alpha) {
+  if constexpr (blend_painter<P>) {
+    p.fill_rect_blend(r.x(), r.y(), static_cast<i16>(r.w()),
+                      static_cast<i16>(r.h()), color, alpha);
+  } else {
+    for (i16 y = r.y(); y < r.bottom(); ++y)
+      hline_blend(p, r.x(), y, static_cast<i16>(r.w()), color, alpha);
+  }
+}
+
+template <typename F>
+void rounded_rect_rows(rect r, i16 radius, F&& row) {
+  u8 scratch[256];
+  const u8* inset = corner_insets(radius, scratch);
+  i16 h = static_cast<i16>(r.h());
+  i16 bot = static_cast<i16>(h - 1 - radius);
+  for (i16 y = 0; y < h; ++y) {
+    i16 in = radius;
+    if (y <= radius) in = std::min<i16>(in, inset[radius - y]);
+    if (y >= bot) in = std::min<i16>(in, inset[y - bot]);
+    if (y >= radius && y < h - radius) in = 0;
+    i16 w = static_cast<i16>(r.w() - 2 * in);
+    if (w > 0)
+      row(static_cast<i16>(r.y() + y), static_cast<i16>(r.x() + in), w);
+  }
+}
+
 template <painter P>
 void rounded_rect_fill(P& p, rect r, i16 radius, u16 color) {
   if (radius <= 0 || r.w() < 2 * radius || r.h() < 2 * radius) {
@@ -14,50 +140,49 @@ void rounded_rect_fill(P& p, rect r, i16 radius, u16 color) {
                 color);
     return;
   }
+  rounded_rect_rows(r, std::min<i16>(radius, 255),
+                    [&](i16 y, i16 x, i16 w) { p.hline(x, y, w, color); });
+}
 
-  p.fill_rect(static_cast<i16>(r.x() + radius), r.y(),
-              static_cast<i16>(r.w() - 2 * radius), static_cast<i16>(r.h()),
-              color);
-
-  p.fill_rect(r.x(), static_cast<i16>(r.y() + radius), static_cast<i16>(radius),
-              static_cast<i16>(r.h() - 2 * radius), color);
-
-  p.fill_rect(static_cast<i16>(r.right() - radius),
-              static_cast<i16>(r.y() + radius), static_cast<i16>(radius),
-              static_cast<i16>(r.h() - 2 * radius), color);
-
-  i16 cx_tl = static_cast<i16>(r.x() + radius);
-  i16 cy_tl = static_cast<i16>(r.y() + radius);
-  i16 cx_tr = static_cast<i16>(r.right() - radius - 1);
-  i16 cx_bl = static_cast<i16>(r.x() + radius);
-  i16 cy_bl = static_cast<i16>(r.bottom() - radius - 1);
-  i16 cx_br = static_cast<i16>(r.right() - radius - 1);
-
-  i16 f = 1 - radius;
-  i16 dd_f_x = 1;
-  i16 dd_f_y = -2 * radius;
-  i16 px = 0;
-  i16 py = radius;
-
-  while (px <= py) {
-    p.hline(static_cast<i16>(cx_tl - px), static_cast<i16>(cy_tl - py),
-            static_cast<i16>(cx_tr - cx_tl + 2 * px + 1), color);
-    p.hline(static_cast<i16>(cx_tl - py), static_cast<i16>(cy_tl - px),
-            static_cast<i16>(cx_tr - cx_tl + 2 * py + 1), color);
-    p.hline(static_cast<i16>(cx_bl - px), static_cast<i16>(cy_bl + py),
-            static_cast<i16>(cx_br - cx_bl + 2 * px + 1), color);
-    p.hline(static_cast<i16>(cx_bl - py), static_cast<i16>(cy_bl + px),
-            static_cast<i16>(cx_br - cx_bl + 2 * py + 1), color);
-
-    if (f >= 0) {
-      py--;
-      dd_f_y += 2;
-      f += dd_f_y;
+template <typename Span, typename Edge, typename Middle>
+void rounded_rect_rows_aa(rect r, i16 radius, Span&& span, Edge&& edge,
+                          Middle&& middle) {
+  u32 scale = detail::coverage_scale(2 * radius + 1);
+  i32 outer = static_cast<i32>(radius + 1) * (radius + 1);
+  i16 left = static_cast<i16>(r.x() + radius);
+  i16 right = static_cast<i16>(r.right() - 1 - radius);
+  i16 top = static_cast<i16>(r.y() + radius);
+  i16 bot = static_cast<i16>(r.bottom() - 1 - radius);
+  detail::disc_rows(radius, [&](i16 dy, i16 xs, i16 xe) {
+    if (dy == 0) {
+      if (bot >= top) middle(top, static_cast<i16>(bot - top + 1));
+      return;
     }
-    px++;
-    dd_f_x += 2;
-    f += dd_f_x;
+    i16 y = static_cast<i16>(dy < 0 ? top + dy : bot + dy);
+    i16 w = static_cast<i16>(right - left + 2 * xs + 1);
+    if (w > 0) span(y, static_cast<i16>(left - xs), w);
+    i32 y2 = static_cast<i32>(dy) * dy;
+    for (i16 dx = static_cast<i16>(xs + 1); dx <= xe; ++dx) {
+      u8 a = detail::coverage(outer - y2 - static_cast<i32>(dx) * dx, scale);
+      edge(static_cast<i16>(left - dx), y, a);
+      edge(static_cast<i16>(right + dx), y, a);
+    }
+  });
+}
+
+template <painter P>
+void rounded_rect_fill_aa(P& p, rect r, i16 radius, u16 color) {
+  if (radius <= 0 || r.w() < 2 * radius || r.h() < 2 * radius) {
+    p.fill_rect(r.x(), r.y(), static_cast<i16>(r.w()), static_cast<i16>(r.h()),
+                color);
+    return;
   }
+  rounded_rect_rows_aa(
+      r, radius, [&](i16 y, i16 x, i16 w) { p.hline(x, y, w, color); },
+      [&](i16 x, i16 y, u8 a) { blend_pixel(p, x, y, color, a); },
+      [&](i16 y, i16 h) {
+        p.fill_rect(r.x(), y, static_cast<i16>(r.w()), h, color);
+      });
 }
 
 template <painter P>
@@ -72,49 +197,35 @@ void rounded_rect_outline(P& p, rect r, i16 radius, u16 color) {
     return;
   }
 
-  p.hline(static_cast<i16>(r.x() + radius), r.y(),
-          static_cast<i16>(r.w() - 2 * radius), color);
-  p.hline(static_cast<i16>(r.x() + radius), static_cast<i16>(r.bottom() - 1),
-          static_cast<i16>(r.w() - 2 * radius), color);
-  p.vline(r.x(), static_cast<i16>(r.y() + radius),
-          static_cast<i16>(r.h() - 2 * radius), color);
-  p.vline(static_cast<i16>(r.right() - 1), static_cast<i16>(r.y() + radius),
-          static_cast<i16>(r.h() - 2 * radius), color);
-
-  i16 cx_tl = static_cast<i16>(r.x() + radius);
-  i16 cy_tl = static_cast<i16>(r.y() + radius);
-  i16 cx_tr = static_cast<i16>(r.right() - radius - 1);
-  i16 cy_tr = static_cast<i16>(r.y() + radius);
-  i16 cx_bl = static_cast<i16>(r.x() + radius);
-  i16 cy_bl = static_cast<i16>(r.bottom() - radius - 1);
-  i16 cx_br = static_cast<i16>(r.right() - radius - 1);
-  i16 cy_br = static_cast<i16>(r.bottom() - radius - 1);
-
-  i16 f = 1 - radius;
-  i16 dd_f_x = 1;
-  i16 dd_f_y = -2 * radius;
-  i16 px = 0;
-  i16 py = radius;
-
-  while (px <= py) {
-    p.pixel(static_cast<i16>(cx_tl - px), static_cast<i16>(cy_tl - py), color);
-    p.pixel(static_cast<i16>(cx_tl - py), static_cast<i16>(cy_tl - px), color);
-    p.pixel(static_cast<i16>(cx_tr + px), static_cast<i16>(cy_tr - py), color);
-    p.pixel(static_cast<i16>(cx_tr + py), static_cast<i16>(cy_tr - px), color);
-    p.pixel(static_cast<i16>(cx_bl - px), static_cast<i16>(cy_bl + py), color);
-    p.pixel(static_cast<i16>(cx_bl - py), static_cast<i16>(cy_bl + px), color);
-    p.pixel(static_cast<i16>(cx_br + px), static_cast<i16>(cy_br + py), color);
-    p.pixel(static_cast<i16>(cx_br + py), static_cast<i16>(cy_br + px), color);
-
-    if (f >= 0) {
-      py--;
-      dd_f_y += 2;
-      f += dd_f_y;
+  radius = std::min<i16>(radius, 255);
+  u8 scratch[256];
+  const u8* inset = corner_insets(radius, scratch);
+  i16 w = static_cast<i16>(r.w());
+  i16 h = static_cast<i16>(r.h());
+
+  auto corner_row = [&](i16 y, i16 d) {
+    i16 a = inset[d];
+    i16 b = d == radius ? radius : std::max<i16>(a, inset[d + 1] - 1);
+    if (d == radius || 2 * b >= w - 2) {
+      i16 lo = std::min<i16>(a, w - 1 - b);
+      i16 hi = std::max<i16>(b, w - 1 - a);
+      p.hline(static_cast<i16>(r.x() + lo), y, static_cast<i16>(hi - lo + 1),
+              color);
+      return;
     }
-    px++;
-    dd_f_x += 2;
-    f += dd_f_x;
-  }
+    p.hline(static_cast<i16>(r.x() + a), y, static_cast<i16>(b - a + 1), color);
+    p.hline(static_cast<i16>(r.right() - 1 - b), y, static_cast<i16>(b - a + 1),
+            color);
+  };
+
+  for (i16 d = radius; d >= 0; --d)
+    corner_row(static_cast<i16>(r.y() + radius - d), d);
+  p.vline(r.x(), static_cast<i16>(r.y() + radius + 1),
+          static_cast<i16>(h - 2 * radius - 2), color);
+  p.vline(static_cast<i16>(r.right() - 1), static_cast<i16>(r.y() + radius + 1),
+          static_cast<i16>(h - 2 * radius - 2), color);
+  for (i16 d = 0; d <= radius; ++d)
+    corner_row(static_cast<i16>(r.bottom() - 1 - radius + d), d);
 }
 
 inline i16 text_width(const char* text, u8 font_size) {
@@ -130,9 +241,24 @@ inline i16 text_width(const char* text, u8 font_size) {
 inline i16 text_height(u8 font_size) { return static_cast<i16>(8 * font_size); }
 
 template <painter P>
-void text_centered(P& p, rect r, const char* text, u16 color, u8 font_size) {
-  i16 tw = text_width(text, font_size);
-  i16 th = text_height(font_size);
+i16 text_width(const P& p, const char* text, u8 font_size) {
+  if constexpr (font_painter<P>) {
+    if (const font* f = p.text_font()) return text_width(*f, text);
+  }
+  return text_width(text, font_size);
+}
+
+template <painter P>
+i16 text_height(const P& p, u8 font_size) {
+  if constexpr (font_painter<P>) {
+    if (const font* f = p.text_font()) return f->line_height;
+  }
+  return text_height(font_size);
+}
+
+template <painter P>
+void text_centered(P& p, rect r, const char* text, u16 color, u8 font_size,
+                   i16 tw, i16 th) {
   i16 tx = static_cast<i16>(r.x() + (static_cast<i16>(r.w()) - tw) / 2);
   i16 ty = static_cast<i16>(r.y() + (static_cast<i16>(r.h()) - th) / 2);
   p.set_text_size(font_size);
@@ -141,10 +267,16 @@ void text_centered(P& p, rect r, const char* text, u16 color, u8 font_size) {
   p.print(text);
 }
 
+template <painter P>
+void text_centered(P& p, rect r, const char* text, u16 color, u8 font_size) {
+  text_centered(p, r, text, color, font_size, text_width(p, text, font_size),
+                text_height(p, font_size));
+}
+
 template <painter P>
 void text_left(P& p, rect r, const char* text, u16 color, u8 font_size,
                i16 pad_left = 0) {
-  i16 th = text_height(font_size);
+  i16 th = text_height(p, font_size);
   i16 tx = static_cast<i16>(r.x() + pad_left);
   i16 ty = static_cast<i16>(r.y() + (static_cast<i16>(r.h()) - th) / 2);
   p.set_text_size(font_size);
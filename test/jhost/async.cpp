@@ -0,0 +1,228 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <jemgui/jemgui.hpp>
+#include <mutex>
+#include <thread>
+
+#include "mem_display.hpp"
+#include "screens.hpp"
+
+using namespace jemgui;
+using clock_type = std::chrono::steady_clock;
+
+class threaded_display {
+ public:
+  explicit threaded_display(u32 ns_per_px)
+      : ns_per_px_{ns_per_px}, worker_{[this] { run(); }} {}
+
+  ~threaded_display() {
+    {
+      std::lock_guard lock(mutex_);
+      quit_ = true;
+    }
+    cv_.notify_one();
+    worker_.join();
+  }
+
+  u16 width() const { return mem_.width(); }
+  u16 height() const { return mem_.height(); }
+
+  void blit(u16 x, u16 y, u16 w, u16 h, const u16* data) {
+    blit_async(x, y, w, h, data);
+    while (is_busy()) {
+    }
+  }
+
+  void blit_async(u16 x, u16 y, u16 w, u16 h, const u16* data, u16 stride) {
+    {
+      std::lock_guard lock(mutex_);
+      job_ = {x, y, w, h, stride, data};
+      busy_ = true;
+    }
+    cv_.notify_one();
+  }
+
+  void blit_async(u16 x, u16 y, u16 w, u16 h, const u16* data) {
+    blit_async(x, y, w, h, data, w);
+  }
+
+  bool is_busy() const {
+    if (!busy_) return false;
+    std::this_thread::yield();
+    return busy_;
+  }
+
+  const jhost::mem_display& mem() const { return mem_; }
+
+ private:
+  struct job {
+    u16 x, y, w, h, stride;
+    const u16* data;
+  };
+
+  void run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return quit_ || busy_; });
+      if (quit_) return;
+      job j = job_;
+      lock.unlock();
+      std::this_thread::sleep_for(
+          std::chrono::nanoseconds(static_cast<u64>(j.w) * j.h * ns_per_px_));
+      mem_.blit(j.x, j.y, j.w, j.h, j.data, j.stride);
+      lock.lock();
+      busy_ = false;
+    }
+  }
+
+  jhost::mem_display mem_;
+  u32 ns_per_px_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  job job_ = {};
+  std::atomic<bool> busy_ = false;
+  bool quit_ = false;
+  std::thread worker_;
+};
+
+static u16 ref_buf[320 * 240];
+static u16 front_buf[320 * 240];
+static u16 back_buf[320 * 240];
+static u16 sync_buf[320 * 240];
+
+static jhost::mem_display ref_display;
+
+static bool same(const jhost::mem_display& a, const jhost::mem_display& b) {
+  return std::memcmp(a.pixels(), b.pixels(), 320 * 240 * sizeof(u16)) == 0;
+}
+
+template <typename C>
+static double run_frames(C& fb, ctx<C>& ui, int frames) {
+  jhost::demo_state st;
+  auto t0 = clock_type::now();
+  for (int i = 0; i < frames; ++i) {
+    st.page = static_cast<i16>((i / 8) % jhost::page_count);
+    input_state in;
+    jhost::demo_frame(ui, st, in);
+    fb.flush();
+  }
+  fb.wait();
+  return std::chrono::duration<double, std::milli>(clock_type::now() - t0)
+      .count();
+}
+
+template <u16 StripH>
+static int strip_frames(u32 ns_per_px, u16* ref_strip, u16* buf, u16* back) {
+  jhost::mem_display ref;
+  strip_canvas<jhost::mem_display, StripH> ref_fb(ref, ref_strip);
+  threaded_display out(ns_per_px);
+  strip_canvas<threaded_display, StripH> fb(out, buf, back);
+  ctx ref_ui(ref_fb);
+  ctx ui(fb);
+  jhost::demo_state a;
+  jhost::demo_state b;
+  int mismatches = 0;
+  for (int i = 0; i < 16; ++i) {
+    a.page = b.page = static_cast<i16>((i / 4) % jhost::page_count);
+    jhost::demo_frame(ref_ui, a, input_state{});
+    jhost::demo_frame(ui, b, input_state{});
+    ref_fb.flush();
+    fb.flush();
+    if (i % 4 != 3) continue;
+    fb.wait();
+    if (!same(ref, out.mem())) {
+      std::printf("%u px strips, frame %d: async output differs from sync\n",
+                  StripH, i);
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+int main() {
+  constexpr u32 ns_per_px = 20;
+  constexpr int frames = 64;
+
+  canvas<jhost::mem_display> ref_fb(ref_display, ref_buf);
+  ctx ref_ui(ref_fb);
+
+  threaded_display async_display(ns_per_px);
+  canvas<threaded_display> async_fb(async_display, front_buf, back_buf);
+  ctx async_ui(async_fb);
+
+  jhost::demo_state ref_st;
+  jhost::demo_state async_st;
+  int mismatches = 0;
+  for (int i = 0; i < frames; ++i) {
+    input_state in;
+    if (i % 5 == 2) {
+      in.touch_down = true;
+      in.touch_pos = {static_cast<i16>(20 + i * 4), static_cast<i16>(60 + i)};
+    }
+    jhost::demo_frame(ref_ui, ref_st, in);
+    jhost::demo_frame(async_ui, async_st, in);
+    ref_fb.flush();
+    async_fb.flush();
+    if (i % 8 != 7) continue;
+    async_fb.wait();
+    if (!same(ref_display, async_display.mem())) {
+      std::printf("frame %d: async output differs from sync output\n", i);
+      mismatches++;
+    }
+  }
+
+  u32 seed = 7;
+  auto next = [&](u32 n) {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<i16>((seed >> 16) % n);
+  };
+  for (int i = 0; i < frames * 4; ++i) {
+    for (int k = 0; k < 3; ++k) {
+      i16 x = next(300);
+      i16 y = next(220);
+      i16 w = static_cast<i16>(1 + next(40));
+      i16 h = static_cast<i16>(1 + next(30));
+      u16 c = static_cast<u16>(next(0x10000));
+      ref_fb.fill_rect(x, y, w, h, c);
+      async_fb.fill_rect(x, y, w, h, c);
+    }
+    ref_fb.flush();
+    async_fb.flush();
+    if (i % 16 != 15) continue;
+    async_fb.wait();
+    if (!same(ref_display, async_display.mem())) {
+      std::printf("rect pass %d: async output differs from sync output\n", i);
+      mismatches++;
+    }
+  }
+
+  static u16 strip_ref[320 * 48];
+  static u16 strip_a[320 * 48];
+  static u16 strip_b[320 * 48];
+  mismatches += strip_frames<40>(ns_per_px, strip_ref, strip_a, strip_b);
+  mismatches += strip_frames<48>(ns_per_px, strip_ref, strip_a, nullptr);
+
+  threaded_display sync_display(ns_per_px);
+  canvas<threaded_display> sync_fb(sync_display, sync_buf);
+  ctx sync_ui(sync_fb);
+
+  double sync_ms = run_frames(sync_fb, sync_ui, frames);
+  double async_ms = run_frames(async_fb, async_ui, frames);
+  if (!same(sync_display.mem(), async_display.mem())) {
+    std::printf("timed run: async output differs from sync output\n");
+    mismatches++;
+  }
+  double transfer_ms =
+      static_cast<double>(frames) * 320 * 240 * ns_per_px / 1e6;
+  double render_ms = sync_ms > transfer_ms ? sync_ms - transfer_ms : 0.0;
+  double hidden = render_ms > 0 ? (sync_ms - async_ms) / render_ms : 0.0;
+
+  std::printf("sync  %8.2f ms for %d frames\n", sync_ms, frames);
+  std::printf("async %8.2f ms for %d frames\n", async_ms, frames);
+  std::printf("render time hidden behind transfers: %.0f%%\n", hidden * 100);
+  std::printf("%s\n", mismatches == 0 ? "ok" : "FAILED");
+  return mismatches == 0 ? 0 : 1;
+}
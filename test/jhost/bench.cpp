@@ -0,0 +1,533 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <jemgui/jemgui.hpp>
+
+#include "jemgui_prop.hpp"
+#include "mem_display.hpp"
+#include "screens.hpp"
+
+using namespace jemgui;
+using clock_type = std::chrono::steady_clock;
+
+JEMGUI_FRAMEBUF(framebuf, 320, 240);
+
+static jhost::mem_display display;
+static const char* filter = nullptr;
+static double min_seconds = 0.2;
+
+template <painter P>
+class counting {
+ public:
+  explicit counting(P& p) : p_{p} {}
+
+  u16 width() const { return p_.width(); }
+  u16 height() const { return p_.height(); }
+
+  void fill_rect(i16 x, i16 y, i16 w, i16 h, u16 c) {
+    calls++;
+    if (w > 0 && h > 0) pixels += static_cast<u64>(w) * h;
+    p_.fill_rect(x, y, w, h, c);
+  }
+  void hline(i16 x, i16 y, i16 w, u16 c) {
+    calls++;
+    if (w > 0) pixels += static_cast<u64>(w);
+    p_.hline(x, y, w, c);
+  }
+  void vline(i16 x, i16 y, i16 h, u16 c) {
+    calls++;
+    if (h > 0) pixels += static_cast<u64>(h);
+    p_.vline(x, y, h, c);
+  }
+  void pixel(i16 x, i16 y, u16 c) {
+    calls++;
+    pixels++;
+    p_.pixel(x, y, c);
+  }
+  void fill_circle(i16 x, i16 y, i16 r, u16 c) {
+    calls++;
+    pixels += static_cast<u64>(2 * r + 1) * (2 * r + 1) * 201 / 256;
+    p_.fill_circle(x, y, r, c);
+  }
+  void hline_blend(i16 x, i16 y, i16 w, u16 c, u8 a)
+    requires blend_painter<P>
+  {
+    calls++;
+    if (w > 0) pixels += static_cast<u64>(w);
+    p_.hline_blend(x, y, w, c, a);
+  }
+  void fill_rect_blend(i16 x, i16 y, i16 w, i16 h, u16 c, u8 a)
+    requires blend_painter<P>
+  {
+    calls++;
+    if (w > 0 && h > 0) pixels += static_cast<u64>(w) * h;
+    p_.fill_rect_blend(x, y, w, h, c, a);
+  }
+  void scroll_region(rect r, i16 dx, i16 dy)
+    requires scroll_painter<P>
+  {
+    calls++;
+    p_.scroll_region(r, dx, dy);
+  }
+  void set_cursor(i16 x, i16 y) { p_.set_cursor(x, y); }
+  void set_text_color(u16 c) { p_.set_text_color(c); }
+  void set_text_size(u8 s) { p_.set_text_size(s); }
+  void print(const char* s) { p_.print(s); }
+  void set_clip(rect r) { p_.set_clip(r); }
+  void clear_clip() { p_.clear_clip(); }
+  u16 read_pixel(i16 x, i16 y) const
+    requires readable_painter<P>
+  {
+    return p_.read_pixel(x, y);
+  }
+
+  u64 pixels = 0;
+  u64 calls = 0;
+
+ private:
+  P& p_;
+};
+
+template <typename F>
+static double bench(const char* name, F&& body) {
+  if (filter && !std::strstr(name, filter)) return 0;
+
+  u64 px = body();
+  u64 iters = 1;
+  double elapsed = 0;
+  while (true) {
+    auto t0 = clock_type::now();
+    px = 0;
+    for (u64 i = 0; i < iters; ++i) px += body();
+    elapsed = std::chrono::duration<double>(clock_type::now() - t0).count();
+    if (elapsed >= min_seconds || iters >= (u64{1} << 30)) break;
+    double grow = elapsed > 0 ? min_seconds * 1.2 / elapsed : 10.0;
+    iters = static_cast<u64>(static_cast<double>(iters) *
+                             std::min(std::max(grow, 1.5), 10.0));
+  }
+
+  double ns = elapsed * 1e9 / static_cast<double>(iters);
+  std::printf("%-34s %12llu %14.1f %12llu\n", name,
+              static_cast<unsigned long long>(iters), ns,
+              static_cast<unsigned long long>(px / iters));
+  return ns;
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--quick") == 0)
+      min_seconds = 0.02;
+    else
+      filter = argv[i];
+  }
+
+  canvas<jhost::mem_display> fb(display, framebuf);
+  counting<canvas<jhost::mem_display>> cp(fb);
+
+  std::printf("%-34s %12s %14s %12s\n", "benchmark", "iterations", "ns/op",
+              "px/op");
+
+  for (i16 page = 0; page < jhost::page_count; ++page) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "frame/%s", jhost::page_names[page]);
+    ctx ui(fb);
+    jhost::demo_state st;
+    st.page = page;
+    for (int i = 0; i < 30; ++i) jhost::demo_frame(ui, st, input_state{});
+    fb.flush();
+    bench(name, [&] {
+      display.reset_counters();
+      jhost::demo_frame(ui, st, input_state{});
+      fb.flush();
+      return display.pixels_sent();
+    });
+  }
+
+  for (i16 page = 0; page < jhost::page_count; ++page) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "frame_counted/%s",
+                  jhost::page_names[page]);
+    ctx ui(cp);
+    jhost::demo_state st;
+    st.page = page;
+    for (int i = 0; i < 30; ++i) jhost::demo_frame(ui, st, input_state{});
+    bench(name, [&] {
+      cp.pixels = 0;
+      jhost::demo_frame(ui, st, input_state{});
+      return cp.pixels;
+    });
+  }
+
+  static const char* const names[] = {
+      "temperature", "humidity",   "pressure",   "battery",
+      "voltage",     "current",    "fan speed",  "pump duty",
+      "set point",   "hysteresis", "alarm high", "alarm low",
+      "sample rate", "uptime",     "firmware",   "serial no"};
+  for (const font* f : {static_cast<const font*>(nullptr), &jemgui_prop}) {
+    ctx ui(fb);
+    ui.set_font(f);
+    ui.set_frame_skip(true);
+    auto labels = [&] {
+      ui.begin_frame(input_state{});
+      ui.panel_begin("labels");
+      for (i16 i = 0; i < 64; ++i) {
+        ui.push_id(i);
+        ui.label(names[i & 15]);
+        ui.button(names[(i + 5) & 15]);
+        ui.pop_id();
+      }
+      ui.panel_end();
+      ui.end_frame();
+    };
+    for (int i = 0; i < 3; ++i) labels();
+    const char* name = f ? "ctx/idle 64 labels, prop font" : "ctx/idle 64 labels";
+    bench(name, [&] {
+      labels();
+      return u64{0};
+    });
+  }
+  {
+    anim_pool anims;
+    id targets[24];
+    for (u32 i = 0; i < 24; ++i) targets[i] = mix_id(fnv1a("toggle"), i);
+    volatile i32 sink = 0;
+    u32 frame = 0;
+    bench("anim/ensure + get, 24 widgets", [&] {
+      anims.tick(16);
+      ++frame;
+      i32 sum = 0;
+      for (u32 i = 0; i < 24; ++i) {
+        i32 to = ((frame >> 5) + i) & 1 ? 256 : 0;
+        anims.ensure(targets[i], to, 150);
+        sum += anims.get(targets[i], to);
+      }
+      sink = sum;
+      return u64{0};
+    });
+  }
+  {
+    ctx ui(cp);
+    auto panel = [&] {
+      ui.begin_frame(input_state{});
+      ui.panel_begin("scrolled");
+      for (i16 i = 0; i < 64; ++i) {
+        ui.push_id(i);
+        ui.row();
+        ui.label(names[i & 15]);
+        ui.button(names[(i + 5) & 15]);
+        ui.end();
+        ui.pop_id();
+      }
+      ui.panel_end();
+      ui.end_frame();
+    };
+    for (int i = 0; i < 3; ++i) panel();
+    bench("ctx/scrolled panel 64 rows", [&] {
+      cp.pixels = 0;
+      panel();
+      return cp.pixels;
+    });
+  }
+  static const char* const flings[] = {"ctx/kinetic fling 64 rows",
+                                       "frame/kinetic fling 64 rows",
+                                       "frame/kinetic fling, scroll_rows"};
+  for (int mode = 0; mode < 3; ++mode) {
+    ctx ui(cp);
+    display.enable_scroll(mode == 2);
+    int n = 0;
+    auto fling = [&] {
+      int t = n++ % 40;
+      input_state in;
+      if (t < 4) {
+        i16 dy = static_cast<i16>(n / 40 % 2 ? 10 : -10);
+        in.touch_down = true;
+        in.touch_pos = {160, static_cast<i16>(120 + t * dy)};
+      }
+      ui.begin_frame(in);
+      ui.panel_begin("kinetic");
+      for (i16 i = 0; i < 64; ++i) {
+        ui.push_id(i);
+        ui.row();
+        ui.label(names[i & 15]);
+        ui.button(names[(i + 5) & 15]);
+        ui.end();
+        ui.pop_id();
+      }
+      ui.panel_end();
+      ui.end_frame();
+    };
+    for (int i = 0; i < 40; ++i) fling();
+    bench(flings[mode], [&] {
+      cp.pixels = 0;
+      display.reset_counters();
+      fling();
+      if (mode == 0) return cp.pixels;
+      fb.flush();
+      return display.pixels_sent();
+    });
+    display.enable_scroll(false);
+  }
+  for (u32 count : {200u, 20000u}) {
+    static const table_column columns[] = {{"#", 60}, {"name", 0}};
+    ctx ui(cp);
+    auto lists = [&] {
+      ui.begin_frame(input_state{});
+      ui.panel_begin("lists");
+      for (u32 i : ui.list_begin("list", count, 0, 90))
+        ui.list_item(names[i & 15], false);
+      ui.list_end();
+      for (u32 i : ui.table_begin("table", columns, count, 14)) {
+        ui.table_cell_fmt("{}", i);
+        ui.table_cell(names[i & 15]);
+      }
+      ui.table_end();
+      ui.panel_end();
+      ui.end_frame();
+    };
+    for (int i = 0; i < 3; ++i) lists();
+    char name[64];
+    std::snprintf(name, sizeof(name), "ctx/list + table %u rows", count);
+    bench(name, [&] {
+      cp.pixels = 0;
+      lists();
+      return cp.pixels;
+    });
+  }
+  sample_ring<1024> samples;
+  u32 seed = 1;
+  auto feed = [&](int n) {
+    for (int i = 0; i < n; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      samples.push(static_cast<i16>((seed >> 16) & 4095) - 2048);
+    }
+  };
+  feed(1024);
+  {
+    ctx ui(cp);
+    auto frame = [&] {
+      feed(17);
+      ui.begin_frame(input_state{});
+      ui.plot("1 kHz", samples, -2048, 2047, 3, 100);
+      ui.end_frame();
+    };
+    for (int i = 0; i < 3; ++i) frame();
+    bench("ctx/plot 1 kHz strip, 17 new/frame", [&] {
+      cp.pixels = 0;
+      frame();
+      return cp.pixels;
+    });
+  }
+  fb.set_font(nullptr);
+
+  const u16 c0 = rgb565(90, 120, 255);
+  const u16 c1 = rgb565(20, 30, 60);
+  const rect r = {{40, 40}, {120, 24}};
+  const rect big = {{20, 20}, {280, 200}};
+
+  auto primitive = [&](const char* name, auto&& draw_fn) {
+    bench(name, [&] {
+      cp.pixels = 0;
+      draw_fn();
+      return cp.pixels;
+    });
+  };
+
+  primitive("canvas/fill_rect 120x24", [&] { cp.fill_rect(40, 40, 120, 24, c0); });
+  primitive("canvas/fill_rect_blend 120x24", [&] {
+    cp.fill_rect_blend(40, 40, 120, 24, c0, 96);
+  });
+  primitive("canvas/fill_rect_blend 320x240", [&] {
+    cp.fill_rect_blend(0, 0, 320, 240, c0, 96);
+  });
+  primitive("draw/blend_pixel 120x24", [&] {
+    for (i16 y = 40; y < 64; ++y)
+      for (i16 x = 40; x < 160; ++x) draw::blend_pixel(cp, x, y, c0, 96);
+  });
+  primitive("draw/fill_circle_blend_aa r16", [&] {
+    draw::fill_circle_blend_aa(cp, 100, 100, 16, c0, 96);
+  });
+  primitive("canvas/hline 200", [&] { cp.hline(60, 100, 200, c0); });
+  primitive("canvas/vline 200", [&] { cp.vline(100, 20, 200, c0); });
+  primitive("canvas/pixel x100", [&] {
+    for (i16 i = 0; i < 100; ++i) cp.pixel(i, static_cast<i16>(i & 63), c0);
+  });
+  primitive("canvas/fill_circle r8", [&] { cp.fill_circle(100, 100, 8, c0); });
+  primitive("canvas/fill_circle r40", [&] { cp.fill_circle(160, 120, 40, c0); });
+  primitive("draw/rounded_rect_fill r4", [&] {
+    draw::rounded_rect_fill(cp, r, 4, c0);
+  });
+  primitive("draw/rounded_rect_fill r12 big", [&] {
+    draw::rounded_rect_fill(cp, big, 12, c0);
+  });
+  primitive("draw/rounded_rect_outline r4", [&] {
+    draw::rounded_rect_outline(cp, r, 4, c0);
+  });
+  primitive("draw/rounded_rect_gradient_v r4", [&] {
+    draw::rounded_rect_gradient_v(cp, r, 4, c0, c1);
+  });
+  primitive("draw/rounded_rect_gradient_v r4 dither", [&] {
+    draw::rounded_rect_gradient_v(cp, r, 4, c0, c1, true);
+  });
+  {
+    u16 rows[24];
+    draw::gradient_dda g(c0, c1, 24);
+    for (i16 y = 0; y < 24; ++y, g.next()) rows[y] = g.color();
+    primitive("draw/rounded_rect_gradient_v r4 cached", [&] {
+      draw::rounded_rect_gradient_v(cp, r, 4, rows);
+    });
+  }
+  primitive("draw/gradient_v 120x24", [&] { draw::gradient_v(cp, r, c0, c1); });
+  primitive("draw/gradient_v 120x24 dither", [&] {
+    draw::gradient_v(cp, r, c0, c1, true);
+  });
+  primitive("draw/gradient_h 120x24", [&] { draw::gradient_h(cp, r, c0, c1); });
+  primitive("draw/gradient_h 120x24 dither", [&] {
+    draw::gradient_h(cp, r, c0, c1, true);
+  });
+  primitive("draw/shadow panel", [&] {
+    draw::shadow(cp, big, 4, themes::dark.bg, 3, 2, 2);
+  });
+  primitive("draw/plot_strip 300x100, 3/col", [&] {
+    draw::plot_strip(cp, {{10, 10}, {300, 100}}, samples, 3, -2048, 2047, c0,
+                     c1);
+  });
+  primitive("draw/plot_fit 1024 -> 300 cols", [&] {
+    draw::plot_fit(cp, {{10, 10}, {300, 100}}, samples, -2048, 2047, c0, c1);
+  });
+  primitive("draw/circle_outline r12", [&] {
+    draw::circle_outline(cp, 100, 100, 12, c0);
+  });
+  for (auto [radius, inner] : {std::pair<i16, i16>{28, 20}, {60, 44}}) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "draw/arc_fill gauge r%d", radius);
+    primitive(name, [&] {
+      draw::arc_fill(cp, 160, 120, radius, inner, 135, 45, c0);
+    });
+    cp.calls = 0;
+    draw::arc_fill(cp, 160, 120, radius, inner, 135, 45, c0);
+    if (!filter || std::strstr(name, filter))
+      std::printf("%-34s %llu painter calls\n", "",
+                  static_cast<unsigned long long>(cp.calls));
+    std::snprintf(name, sizeof(name), "draw/arc_fill_aa gauge r%d", radius);
+    primitive(name, [&] {
+      draw::arc_fill_aa(cp, 160, 120, radius, inner, 135, 45, c0);
+    });
+  }
+  primitive("draw/fill_circle_aa r8", [&] {
+    draw::fill_circle_aa(cp, 100, 100, 8, c0);
+  });
+  primitive("draw/fill_circle_aa r40", [&] {
+    draw::fill_circle_aa(cp, 160, 120, 40, c0);
+  });
+  primitive("draw/rounded_rect_fill_aa r4", [&] {
+    draw::rounded_rect_fill_aa(cp, r, 4, c0);
+  });
+  primitive("draw/rounded_rect_fill_aa r12 big", [&] {
+    draw::rounded_rect_fill_aa(cp, big, 12, c0);
+  });
+  primitive("draw/rounded_rect_gradient_v_aa r4", [&] {
+    draw::rounded_rect_gradient_v_aa(cp, r, 4, c0, c1);
+  });
+  primitive("draw/line_aa 200x70", [&] {
+    draw::line_aa(cp, 60, 80, 260, 150, c0);
+  });
+  primitive("draw/text_centered", [&] {
+    draw::text_centered(cp, r, "button label", c0, 1);
+  });
+
+  const char* sample = "The quick brown fox 0123456789";
+  double ns = bench("canvas/print size 1 (30 glyphs)", [&] {
+    fb.set_text_size(1);
+    fb.set_text_color(c0);
+    fb.set_cursor(4, 100);
+    fb.print(sample);
+    return u64{0};
+  });
+  if (ns > 0) std::printf("%-34s %.2f Mglyph/s\n", "", 30e3 / ns);
+
+  for (u8 size = 1; size <= 4; ++size) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "canvas/print size %u digits", size);
+    ns = bench(name, [&] {
+      fb.set_text_size(size);
+      fb.set_text_color(c0);
+      fb.set_cursor(4, 100);
+      fb.print("0123456789");
+      return u64{0};
+    });
+    if (ns > 0) std::printf("%-34s %.2f Mglyph/s\n", "", 10e3 / ns);
+  }
+
+  const char* line = "a full row of size 1 text, clipped at both edges....";
+  ns = bench("canvas/print size 1 clipped page", [&] {
+    fb.set_text_size(1);
+    fb.set_text_color(c0);
+    fb.set_clip({{10, 10}, {300, 220}});
+    for (i16 y = 0; y < 240; y = static_cast<i16>(y + 8)) {
+      fb.set_cursor(0, y);
+      fb.print(line);
+    }
+    fb.clear_clip();
+    return u64{0};
+  });
+  if (ns > 0)
+    std::printf("%-34s %.2f Mglyph/s\n", "",
+                30e3 * static_cast<double>(std::strlen(line)) / ns);
+
+  const u16 bands[] = {1, 8, 24, 40, 120, 240};
+  for (u16 band : bands) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "flush/band 320x%u", band);
+    bench(name, [&] {
+      display.reset_counters();
+      fb.fill_rect(0, 0, 320, static_cast<i16>(band), c0);
+      fb.flush();
+      return display.pixels_sent();
+    });
+  }
+
+  {
+    char buf[64];
+    u32 n = 12345;
+    i32 t = -235;
+    float f = 3.14159f;
+    volatile usize len = 0;
+    auto fmt_case = [&](const char* name, auto&& fn) {
+      bench(name, [&] {
+        n = n * 1664525u + 1013904223u;
+        len = static_cast<usize>(fn());
+        return u64{0};
+      });
+    };
+    fmt_case("fmt/snprintf %lu", [&] {
+      return std::snprintf(buf, sizeof(buf), "f:%lu",
+                           static_cast<unsigned long>(n));
+    });
+    fmt_case("fmt/format_to {}", [&] { return format_to(buf, "f:{}", n); });
+    fmt_case("fmt/snprintf %04x %6d", [&] {
+      return std::snprintf(buf, sizeof(buf), "%04x %6d", n & 0xFFFF,
+                           static_cast<int>(t));
+    });
+    fmt_case("fmt/format_to {:04x} {:6}", [&] {
+      return format_to(buf, "{:04x} {:6}", n & 0xFFFF, t);
+    });
+    fmt_case("fmt/snprintf %.2f", [&] {
+      return std::snprintf(buf, sizeof(buf), "%.2f", static_cast<double>(f));
+    });
+    fmt_case("fmt/format_to {:.2}", [&] { return format_to(buf, "{:.2}", f); });
+    fmt_case("fmt/format_to {:.1} fixed-point", [&] {
+      return format_to(buf, "{:.1} C", t);
+    });
+  }
+
+  bench("flush/two small rects", [&] {
+    display.reset_counters();
+    fb.fill_rect(10, 10, 20, 12, c0);
+    fb.fill_rect(250, 180, 40, 12, c1);
+    fb.flush();
+    return display.pixels_sent();
+  });
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <cstring>
+#include <jemgui/format.hpp>
+#include <random>
+
+using namespace jemgui;
+
+static int failed = 0;
+static int checked = 0;
+
+static void expect(const char* got, const char* want, const char* what) {
+  checked++;
+  if (std::strcmp(got, want) == 0) return;
+  failed++;
+  std::printf("FAIL %s: got \"%s\", want \"%s\"\n", what, got, want);
+}
+
+template <typename... Args>
+static void check(const char* want,
+                  format_string<std::type_identity_t<Args>...> fmt,
+                  const Args&... args) {
+  char buf[64];
+  usize n = format_to(buf, fmt, args...);
+  expect(buf, want, fmt.get());
+  if (n != std::strlen(want)) {
+    failed++;
+    std::printf("FAIL %s: returned length %zu, want %zu\n", fmt.get(), n,
+                std::strlen(want));
+  }
+}
+
+static constexpr bool constant_ok() {
+  char buf[16] = {};
+  format_to(buf, "{:04x}|{:>3}", 0xBEu, 7);
+  const char* want = "00be|  7";
+  for (usize i = 0; want[i]; ++i)
+    if (buf[i] != want[i]) return false;
+  return true;
+}
+static_assert(constant_ok());
+
+int main() {
+  check("f:29", "f:{}", 29ul);
+  check("plain", "plain");
+  check("{x}", "{{x}}");
+  check("-42 42", "{} {}", -42, 42u);
+  check("-2147483648", "{}", static_cast<i32>(-2147483647 - 1));
+  check("18446744073709551615", "{}", ~u64{0});
+  check("-9223372036854775808", "{}", static_cast<i64>(u64{1} << 63));
+  check("ff FF 00ff", "{:x} {:X} {:04x}", 255, 255u, 255);
+  check("[   7] [7   ] [ 7  ]", "[{:4}] [{:<4}] [{:^4}]", 7, 7, 7);
+  check("[-0007] [**ab]", "[{:05}] [{:*>4}]", -7, "ab");
+  check("23.5 C", "{:.1} C", 235);
+  check("-0.05", "{:.2}", -5);
+  check("1.000", "{:.3}", 1000u);
+  check("3.14 2.718 -0.5", "{} {:.3} {:.1}", 3.14159f, 2.71828, -0.5f);
+  check("000.25", "{:06.2}", 0.25f);
+  check("true false", "{} {}", true, false);
+  check("A 65 41", "{} {:d} {:x}", 'A', 'A', 'A');
+  check("name:  ok", "name: {:>3}", "ok");
+  check("nan inf -inf", "{} {} {}", 0.0f / 0.0f, 1e30f, -1e30);
+
+  char small[5];
+  usize n = format_to(small, "{}", 1234567);
+  expect(small, "1234", "truncation");
+  if (n != 4) failed++;
+
+  std::mt19937 rng(1);
+  char want[64];
+  char got[64];
+  for (int i = 0; i < 20000; ++i) {
+    i32 v = static_cast<i32>(rng()) >> (rng() % 32);
+    u32 u = static_cast<u32>(v);
+    std::snprintf(want, sizeof(want), "%d|%08d|%x|%12u|%-12d|", v, v, u, u, v);
+    format_to(got, "{}|{:08}|{:x}|{:12}|{:<12}|", v, v, u, u, v);
+    expect(got, want, "random integers");
+  }
+  for (int i = 0; i < 20000; ++i) {
+    i32 v = static_cast<i32>(rng()) >> (rng() % 32);
+    i32 mag = v < 0 ? -(v / 100) : v / 100;
+    i32 frac = v < 0 ? -(v % 100) : v % 100;
+    std::snprintf(want, sizeof(want), "%s%d.%02d", v < 0 ? "-" : "",
+                  static_cast<int>(mag), static_cast<int>(frac));
+    format_to(got, "{:.2}", v);
+    expect(got, want, "random fixed-point");
+  }
+
+  std::printf("%d of %d format checks pass\n", checked - failed, checked);
+  return failed == 0 ? 0 : 1;
+}
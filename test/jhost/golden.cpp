@@ -0,0 +1,753 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <jemgui/jemgui.hpp>
+#include <vector>
+
+#include "jemgui_prop.hpp"
+#include "jemgui_prop_aa.hpp"
+#include "mem_display.hpp"
+#include "screens.hpp"
+
+using namespace jemgui;
+
+JEMGUI_FRAMEBUF(framebuf, 480, 320);
+JEMGUI_STRIPBUF(stripbuf, 480, 40);
+JEMGUI_FRAMEBUF(tilebuf, 96, 56);
+
+static jhost::mem_display display;
+static jhost::mem_display tile_display(96, 56);
+
+struct image {
+  u16 w = 0;
+  u16 h = 0;
+  std::vector<u16> px;
+};
+
+struct size_case {
+  u16 w;
+  u16 h;
+};
+
+static constexpr size_case sizes[] = {
+    {320, 240},
+    {240, 320},
+    {480, 320},
+    {160, 128},
+};
+
+struct theme_case {
+  const char* name;
+  const theme* t;
+};
+
+static constexpr theme_case theme_cases[] = {
+    {"dark", &themes::dark},
+    {"light", &themes::light},
+    {"mono", &themes::mono},
+};
+
+struct font_case {
+  const char* name;
+  const font* f;
+};
+
+static constexpr font_case font_cases[] = {
+    {"prop", &jemgui_prop},
+    {"prop_aa", &jemgui_prop_aa},
+};
+
+static void put_u16(std::FILE* f, u16 v) {
+  u8 b[2] = {static_cast<u8>(v), static_cast<u8>(v >> 8)};
+  std::fwrite(b, 1, 2, f);
+}
+
+static bool get_u16(std::FILE* f, u16& v) {
+  u8 b[2];
+  if (std::fread(b, 1, 2, f) != 2) return false;
+  v = static_cast<u16>(b[0] | (b[1] << 8));
+  return true;
+}
+
+static bool save_image(const char* path, const image& img) {
+  std::FILE* f = std::fopen(path, "wb");
+  if (!f) return false;
+  std::fwrite("J565", 1, 4, f);
+  put_u16(f, img.w);
+  put_u16(f, img.h);
+  usize n = img.px.size();
+  for (usize i = 0; i < n;) {
+    usize run = 1;
+    while (i + run < n && run < 0xFFFF && img.px[i + run] == img.px[i]) run++;
+    put_u16(f, static_cast<u16>(run));
+    put_u16(f, img.px[i]);
+    i += run;
+  }
+  return std::fclose(f) == 0;
+}
+
+static bool load_image(const char* path, image& img) {
+  std::FILE* f = std::fopen(path, "rb");
+  if (!f) return false;
+  char magic[4];
+  bool ok = std::fread(magic, 1, 4, f) == 4 &&
+            std::memcmp(magic, "J565", 4) == 0 && get_u16(f, img.w) &&
+            get_u16(f, img.h);
+  usize n = ok ? static_cast<usize>(img.w) * img.h : 0;
+  img.px.clear();
+  img.px.reserve(n);
+  while (ok && img.px.size() < n) {
+    u16 run;
+    u16 c;
+    ok = get_u16(f, run) && get_u16(f, c) && run > 0 &&
+         img.px.size() + run <= n;
+    if (ok) img.px.insert(img.px.end(), run, c);
+  }
+  std::fclose(f);
+  return ok;
+}
+
+static image grab() {
+  image img;
+  img.w = display.width();
+  img.h = display.height();
+  img.px.assign(display.pixels(),
+                display.pixels() + static_cast<usize>(img.w) * img.h);
+  return img;
+}
+
+template <painter P>
+static void primitives(P& p, const theme& t) {
+  const u16 c0 = t.accent;
+  const u16 c1 = t.success;
+  const u16 c2 = t.danger;
+
+  p.fill_screen(t.bg);
+
+  for (i16 i = 0; i < 7; ++i) {
+    rect r = {{static_cast<i16>(4 + i * 44), 4}, {40, 28}};
+    draw::rounded_rect_fill(p, r, i * 2, c0);
+    rect o = {{static_cast<i16>(4 + i * 44), 36}, {40, 28}};
+    draw::rounded_rect_outline(p, o, i * 2, t.border);
+  }
+
+  draw::gradient_v(p, {{4, 70}, {60, 40}}, c0, c2);
+  draw::gradient_h(p, {{68, 70}, {60, 40}}, c1, c0);
+  draw::rounded_rect_gradient_v(p, {{132, 70}, {60, 40}}, 8, c2, c1);
+  draw::shadow(p, {{204, 74}, {52, 32}}, 4, t.bg, 3, 2, 2);
+  draw::rounded_rect_fill(p, {{204, 74}, {52, 32}}, 4, t.surface);
+  draw::rounded_rect_gradient_v(p, {{264, 70}, {3, 40}}, 6, c0, c1);
+  draw::rounded_rect_fill(p, {{272, 70}, {40, 3}}, 6, c1);
+
+  draw::circle_outline(p, 24, 140, 16, c0);
+  p.fill_circle(64, 140, 16, c1);
+  p.fill_circle(96, 140, 1, c2);
+  p.fill_circle(110, 140, 0, c2);
+  draw::arc_fill(p, 150, 144, 28, 20, 135, 45, t.surface_alt);
+  draw::arc_fill(p, 150, 144, 28, 20, 135, 270, c0);
+  draw::arc_fill(p, 220, 144, 24, 0, 0, 90, c1);
+  draw::arc_fill(p, 220, 144, 24, 12, 200, 340, c2);
+  draw::arc_fill(p, 280, 144, 20, 17, 90, 89, c0);
+
+  const i16 text_y[] = {166, 178, 196};
+  for (u8 fs = 1; fs <= 3; ++fs) {
+    p.set_text_size(fs);
+    p.set_text_color(t.text);
+    p.set_cursor(4, text_y[fs - 1]);
+    p.print("Ag0~!{|}");
+  }
+  p.set_text_size(1);
+  p.set_text_color(t.text_dim);
+  p.set_cursor(220, 176);
+  p.print("two\nlines");
+
+  p.hline(-10, 230, 40, c0);
+  p.vline(316, 200, 60, c1);
+  p.fill_rect(300, -5, 40, 12, c2);
+  p.fill_circle(-4, 236, 10, c0);
+  p.set_clip({{120, 200}, {60, 24}});
+  p.fill_rect(100, 190, 100, 50, t.surface_alt);
+  p.set_text_color(t.text);
+  p.set_cursor(110, 208);
+  p.print("clipped text");
+  p.fill_circle(175, 222, 8, c2);
+  p.clear_clip();
+}
+
+template <painter P>
+static void arcs(P& p, const theme& t) {
+  p.fill_screen(t.bg);
+  const i16 radii[] = {10, 20, 36};
+  i16 x = 4;
+  for (i16 r : radii) {
+    i16 cx = static_cast<i16>(x + r);
+    i16 in = static_cast<i16>(r * 3 / 4);
+    draw::arc_fill(p, cx, 60, r, in, 135, 45, t.surface_alt);
+    draw::arc_fill(p, cx, 60, r, in, 135, 330, t.accent);
+    draw::arc_fill_aa(p, cx, 160, r, in, 135, 45, t.surface_alt, t.bg);
+    draw::arc_fill_aa(p, cx, 160, r, in, 135, 330, t.accent, t.bg);
+    x = static_cast<i16>(x + 2 * r + 12);
+  }
+  draw::arc_fill_aa(p, 250, 60, 30, 0, 0, 360, t.success, t.bg);
+  draw::arc_fill_aa(p, 250, 60, 14, 13, 0, 360, t.bg, t.success);
+  p.fill_rect(204, 116, 112, 88, t.surface);
+  draw::arc_fill_aa(p, 260, 160, 40, 30, 200, 340, t.danger, t.surface);
+  draw::arc_fill_aa(p, 260, 160, 24, 0, 30, 150, t.accent, t.surface);
+  draw::arc_fill(p, 60, 226, 8, 5, 0, 360, t.text);
+  draw::arc_fill_aa(p, 100, 226, 8, 5, 0, 360, t.text, t.bg);
+  draw::arc_fill_aa(p, 140, 226, 3, 1, 0, 360, t.text);
+}
+
+template <painter P>
+static void antialiased(P& p, const theme& t) {
+  p.fill_screen(t.bg);
+  for (i16 i = 0; i < 6; ++i) {
+    i16 r = static_cast<i16>(1 + i * 3);
+    i16 x = static_cast<i16>(14 + i * 36);
+    draw::fill_circle_aa(p, x, 22, r, t.accent);
+    p.fill_circle(x, 62, r, t.accent);
+    rect rr = {{static_cast<i16>(x - 14), 88}, {30, 22}};
+    draw::rounded_rect_fill_aa(p, rr, static_cast<i16>(i * 2), t.success);
+  }
+  draw::rounded_rect_gradient_v_aa(p, {{220, 8}, {92, 30}}, 8, t.accent,
+                                   t.danger);
+  draw::rounded_rect_gradient_v_aa(p, {{220, 44}, {20, 20}}, 10, t.text, t.bg);
+  draw::rounded_rect_fill_aa(p, {{248, 44}, {64, 64}}, 32, t.surface_alt);
+  draw::fill_circle_aa(p, 280, 76, 20, t.warning);
+
+  for (i16 i = 0; i < 24; ++i) {
+    i16 dx = static_cast<i16>(i < 12 ? 50 : 50 - (i - 12) * 8);
+    i16 dy = static_cast<i16>(i < 12 ? i * 4 : 50);
+    draw::line_aa(p, 60, 180, static_cast<i16>(60 + dx),
+                  static_cast<i16>(180 - dy), t.text);
+    draw::line_aa(p, 60, 180, static_cast<i16>(60 - dx),
+                  static_cast<i16>(180 + dy), t.accent);
+  }
+  p.fill_rect(150, 120, 166, 116, t.surface);
+  draw::line_aa(p, 156, 230, 310, 126, t.danger);
+  draw::line_aa(p, 156, 126, 310, 230, t.success);
+  draw::fill_circle_aa(p, 200, 178, 30, t.accent);
+  draw::fill_circle_aa(p, 220, 190, 24, t.danger);
+  draw::rounded_rect_fill_aa(p, {{250, 140}, {56, 40}}, 10, t.text_dim);
+  draw::arc_fill_aa(p, 278, 208, 22, 16, 90, 0, t.warning);
+}
+
+template <painter P>
+static void blended(P& p, const theme& t) {
+  p.fill_screen(t.bg);
+  const u16 stripes[4] = {t.accent, t.success, t.warning, t.danger};
+  for (i16 i = 0; i < 16; ++i)
+    p.fill_rect(static_cast<i16>(i * 20), 0, 20, 120, stripes[i & 3]);
+  for (i16 i = 0; i < 8; ++i) {
+    rect r = {{static_cast<i16>(3 + i * 39), static_cast<i16>(8 + (i & 1))},
+              {static_cast<u16>(33 + (i & 1)), 48}};
+    draw::fill_rect_blend(p, r, t.surface, static_cast<u8>(32 * i + 16));
+  }
+  for (i16 i = 0; i < 12; ++i)
+    draw::hline_blend(p, static_cast<i16>(1 + i), static_cast<i16>(64 + i * 4),
+                      static_cast<i16>(317 - 2 * i), t.text,
+                      static_cast<u8>(i * 23));
+  draw::fill_rect_blend(p, {{-10, 112}, {340, 16}}, 0x0000, 128);
+
+  draw::rounded_rect_fill_aa(p, {{10, 150}, {300, 8}}, 4, t.surface_alt);
+  draw::rounded_rect_fill_aa(p, {{10, 150}, {140, 8}}, 4, t.accent);
+  for (i16 i = 0; i < 4; ++i) {
+    i16 x = static_cast<i16>(40 + i * 76);
+    draw::fill_circle_blend_aa(p, x, 154, static_cast<i16>(8 + i * 2),
+                               t.accent, static_cast<u8>(40 + i * 40));
+    draw::fill_circle_aa(p, x, 154, 5, t.accent);
+    draw::fill_circle_blend(p, x, 200, static_cast<i16>(14 + i * 4), t.text,
+                            static_cast<u8>(60 + i * 40));
+  }
+}
+
+template <painter P>
+static void gradients(P& p, const theme& t) {
+  p.fill_screen(t.bg);
+  draw::gradient_v(p, {{4, 4}, {64, 100}}, t.bg, t.surface_alt);
+  draw::gradient_v(p, {{73, 6}, {64, 100}}, t.bg, t.surface_alt, true);
+  draw::gradient_v(p, {{142, 4}, {64, 100}}, t.surface, t.accent, true);
+  draw::gradient_v(p, {{211, 7}, {3, 100}}, t.accent, t.danger, true);
+  draw::gradient_v(p, {{218, 5}, {98, 100}}, t.danger, t.warning, true);
+  draw::gradient_h(p, {{4, 110}, {150, 40}}, t.accent, t.bg);
+  draw::gradient_h(p, {{161, 113}, {155, 37}}, t.accent, t.bg, true);
+  draw::rounded_rect_gradient_v(p, {{4, 156}, {96, 78}}, 10, t.success,
+                                t.bg);
+  draw::rounded_rect_gradient_v(p, {{107, 157}, {97, 78}}, 10, t.success,
+                                t.bg, true);
+  draw::rounded_rect_gradient_v_aa(p, {{211, 159}, {105, 75}}, 13,
+                                   t.surface_alt, t.accent, true);
+}
+
+template <painter P>
+static void occluded(P& p, const theme& t) {
+  p.fill_rect(0, 0, static_cast<i16>(p.width()), static_cast<i16>(p.height()),
+              t.bg);
+  for (i16 i = 0; i < 4; ++i) {
+    i16 x = static_cast<i16>(8 + i * 78);
+    p.fill_rect(x, 8, 70, 60, t.surface);
+    p.set_cursor(static_cast<i16>(x + 4), 12);
+    p.set_text_color(t.text);
+    p.print("hidden");
+    p.fill_circle(static_cast<i16>(x + 35), 40, 12, t.accent);
+    p.fill_rect(x, 8, 70, 60, t.surface_alt);
+    p.fill_circle(static_cast<i16>(x + 35), 35, 8, t.warning);
+    p.fill_rect_blend(static_cast<i16>(x + 10), 20, 50, 30, t.accent,
+                      static_cast<u8>(64 + i * 48));
+    p.set_cursor(static_cast<i16>(x + 4), 56);
+    p.print("card");
+  }
+
+  p.fill_rect(8, 80, 120, 40, t.warning);
+  p.fill_rect(68, 80, 120, 40, t.success);
+  for (i16 i = 0; i < 10; ++i) {
+    p.hline(200, static_cast<i16>(80 + i * 4), 110, t.text);
+    p.vline(static_cast<i16>(204 + i * 10), 80, 40, t.danger);
+    p.pixel(static_cast<i16>(206 + i * 10), 82, t.accent);
+  }
+  p.fill_rect(200, 80, 60, 40, t.surface);
+
+  p.set_clip({{8, 130}, {100, 40}});
+  p.fill_rect(0, 126, 320, 48, t.danger);
+  p.clear_clip();
+  p.fill_rect(8, 130, 100, 40, t.surface);
+
+  p.fill_rect(120, 130, 190, 40, t.accent);
+  p.set_clip({{120, 130}, {90, 40}});
+  p.fill_rect(120, 130, 190, 40, t.text);
+  p.clear_clip();
+
+  p.set_clip({{8, 180}, {300, 52}});
+  p.fill_rect(8, 180, 300, 52, t.surface);
+  p.set_cursor(12, 186);
+  p.set_text_color(t.text);
+  p.print("under\nthe clip");
+  p.fill_rect(0, 204, 320, 36, t.surface_alt);
+  p.clear_clip();
+}
+
+template <typename F>
+static image render_page(F& fb, const theme& t, i16 page) {
+  ctx ui(fb, t);
+  jhost::demo_state st;
+  st.page = page;
+  for (int i = 0; i < 60; ++i) {
+    jhost::demo_frame(ui, st, input_state{});
+    fb.flush();
+  }
+  return grab();
+}
+
+static image render_tiles(const theme& t, i16 page) {
+  static display_list<32768> frame(320, 240);
+  static canvas<jhost::mem_display> tile(tile_display, tilebuf);
+  ctx ui(frame, t);
+  jhost::demo_state st;
+  st.page = page;
+  for (int i = 0; i < 60; ++i) {
+    frame.clear();
+    jhost::demo_frame(ui, st, input_state{});
+  }
+  frame.cull_occluded();
+  image img;
+  img.w = 320;
+  img.h = 240;
+  img.px.resize(static_cast<usize>(img.w) * img.h);
+  for (i16 ty = 0; ty < img.h; ty = static_cast<i16>(ty + tile.height())) {
+    for (i16 tx = 0; tx < img.w; tx = static_cast<i16>(tx + tile.width())) {
+      tile.fill_screen(0x0000);
+      frame.replay(tile, rect{{tx, ty}, {tile.width(), tile.height()}});
+      tile.flush();
+      u16 w = std::min<u16>(tile.width(), static_cast<u16>(img.w - tx));
+      u16 h = std::min<u16>(tile.height(), static_cast<u16>(img.h - ty));
+      for (u16 y = 0; y < h; ++y)
+        std::memcpy(&img.px[static_cast<usize>(ty + y) * img.w + tx],
+                    tile_display.pixels() + y * tile.width(),
+                    w * sizeof(u16));
+    }
+  }
+  return img;
+}
+
+static image render_culled(canvas<jhost::mem_display>& fb, const theme& t) {
+  static display_list<32768> frame(320, 240);
+  frame.clear();
+  occluded(frame, t);
+  frame.cull_occluded();
+  frame.replay(fb);
+  fb.flush();
+  return grab();
+}
+
+static image render_font_page(canvas<jhost::mem_display>& fb, const theme& t,
+                              const font& f, i16 page) {
+  ctx ui(fb, t);
+  ui.set_font(&f);
+  jhost::demo_state st;
+  st.page = page;
+  for (int i = 0; i < 60; ++i) {
+    jhost::demo_frame(ui, st, input_state{});
+    fb.flush();
+  }
+  fb.set_font(nullptr);
+  return grab();
+}
+
+static image render_pressed(canvas<jhost::mem_display>& fb, const theme& t) {
+  ctx ui(fb, t);
+  jhost::demo_state st;
+  for (int i = 0; i < 60; ++i) {
+    input_state in;
+    if (i >= 40) {
+      in.touch_down = true;
+      in.touch_pos = {static_cast<i16>(fb.width() / 8),
+                      static_cast<i16>(fb.height() / 10)};
+    }
+    jhost::demo_frame(ui, st, in);
+    fb.flush();
+  }
+  return grab();
+}
+
+static image render_lists(canvas<jhost::mem_display>& fb, const theme& t) {
+  static const char* const names[] = {"boot", "sensor", "net", "storage",
+                                      "ui", "power"};
+  static const table_column columns[] = {
+      {"#", 40}, {"source", 90}, {"value", 0}};
+  ctx ui(fb, t);
+  i16 sel = 3;
+  for (int i = 0; i < 60; ++i) {
+    input_state in;
+    if (i >= 10 && i < 20) {
+      in.touch_down = true;
+      in.touch_pos = {160, static_cast<i16>(100 - (i - 10) * 6)};
+    }
+    ui.begin_frame(in);
+    ui.panel_begin("log");
+    for (u32 n : ui.list_begin("entries", 2000, 0, 84)) {
+      char buf[32];
+      format_to(buf, "{:04} {}", n, names[n % 6]);
+      if (ui.list_item(buf, n == static_cast<u32>(sel)))
+        sel = static_cast<i16>(n);
+    }
+    ui.list_end();
+    for (u32 n : ui.table_begin("table", columns, 2000, 14)) {
+      ui.table_cell_fmt("{}", n);
+      ui.table_cell(names[n % 6]);
+      ui.table_cell_fmt("{:.1}", static_cast<i32>(n * 37 % 1000));
+    }
+    ui.table_end();
+    ui.panel_end();
+    ui.end_frame();
+    fb.flush();
+  }
+  return grab();
+}
+
+static image render_plots(canvas<jhost::mem_display>& fb, const theme& t,
+                          bool repaint_last) {
+  sample_ring<1024> wave;
+  sample_ring<256> load;
+  fb.fill_screen(t.bg);
+  ctx ui(fb, t);
+  u32 seed = 12345;
+  i32 n = 0;
+  for (int i = 0; i < 60; ++i) {
+    for (int k = 0; k < 17; ++k, ++n) {
+      seed = seed * 1103515245u + 12345u;
+      i32 noise = static_cast<i32>((seed >> 16) & 127) - 64;
+      i32 tri = (n % 400) < 200 ? (n % 400) * 8 - 800 : 2400 - (n % 400) * 8;
+      wave.push(static_cast<i16>(tri + noise));
+    }
+    load.push(static_cast<i16>(40 + (i * 37 % 50) + (i & 4) * 5));
+    if (repaint_last && i == 59) ui.recalculate();
+    ui.begin_frame(input_state{});
+    ui.plot("wave", wave, -1000, 1000, 2);
+    ui.row();
+    ui.label("load");
+    ui.sparkline(load, 0, 0);
+    ui.sparkline(wave, 0, 0, 120);
+    ui.end();
+    ui.panel_begin("history");
+    ui.plot("fit", wave, 0, 0, 0, 40);
+    ui.plot("strip", load, 0, 100, 1, 40);
+    ui.panel_end();
+    ui.end_frame();
+    fb.flush();
+  }
+  return grab();
+}
+
+enum class fling { band, repaint, hardware };
+
+static image render_kinetic(canvas<jhost::mem_display>& fb, const theme& t,
+                            fling mode) {
+  static const char* const names[] = {"wifi", "bluetooth", "backlight",
+                                      "sleep", "sound", "sensors", "logging"};
+  fb.fill_screen(t.bg);
+  display.enable_scroll(mode == fling::hardware);
+  ctx ui(fb, t);
+  for (int i = 0; i < 30; ++i) {
+    input_state in;
+    if (i >= 5 && i < 10) {
+      in.touch_down = true;
+      in.touch_pos = {160, static_cast<i16>(150 - (i - 5) * 12)};
+    }
+    if (mode == fling::repaint && i == 29) ui.set_theme(t);
+    ui.begin_frame(in);
+    ui.panel_begin("settings");
+    for (i16 n = 0; n < 40; ++n) {
+      ui.push_id(n);
+      ui.row();
+      ui.label(names[n % 7]);
+      ui.button(n & 1 ? "on" : "off");
+      ui.end();
+      ui.pop_id();
+    }
+    ui.panel_end();
+    ui.end_frame();
+    fb.flush();
+  }
+  display.enable_scroll(false);
+  return grab();
+}
+
+struct report {
+  u32 differing = 0;
+  i16 x0 = 0;
+  i16 y0 = 0;
+  i16 x1 = 0;
+  i16 y1 = 0;
+  u8 max_delta = 0;
+};
+
+static report compare(const image& want, const image& got,
+                      std::vector<u16>& diff) {
+  report r;
+  r.x0 = static_cast<i16>(want.w);
+  r.y0 = static_cast<i16>(want.h);
+  diff.resize(want.px.size());
+  for (u16 y = 0; y < want.h; ++y) {
+    for (u16 x = 0; x < want.w; ++x) {
+      usize i = static_cast<usize>(y) * want.w + x;
+      u16 a = want.px[i];
+      u16 b = got.px[i];
+      if (a == b) {
+        u8 g = static_cast<u8>((rgb565_r(a) + rgb565_g(a) + rgb565_b(a)) / 12);
+        diff[i] = rgb565(g, g, g);
+        continue;
+      }
+      auto delta = [](u8 p, u8 q) {
+        return static_cast<u8>(p > q ? p - q : q - p);
+      };
+      u8 d = std::max({delta(rgb565_r(a), rgb565_r(b)),
+                       delta(rgb565_g(a), rgb565_g(b)),
+                       delta(rgb565_b(a), rgb565_b(b))});
+      r.differing++;
+      r.max_delta = std::max(r.max_delta, d);
+      r.x0 = std::min(r.x0, static_cast<i16>(x));
+      r.y0 = std::min(r.y0, static_cast<i16>(y));
+      r.x1 = std::max(r.x1, static_cast<i16>(x));
+      r.y1 = std::max(r.y1, static_cast<i16>(y));
+      diff[i] = rgb565(255, static_cast<u8>(255 - d), 0);
+    }
+  }
+  return r;
+}
+
+int main(int argc, char** argv) {
+  const char* ref_dir = nullptr;
+  const char* out_dir = ".";
+  const char* filter = nullptr;
+  bool update = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--update") == 0)
+      update = true;
+    else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+      out_dir = argv[++i];
+    else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+      filter = argv[++i];
+    else
+      ref_dir = argv[i];
+  }
+  if (!ref_dir) {
+    std::printf(
+        "usage: jemgui_golden <ref_dir> [--update] [--out dir] "
+        "[--filter name]\n");
+    return 2;
+  }
+
+  canvas<jhost::mem_display> fb(display, framebuf);
+  strip_canvas<jhost::mem_display, 40> strips(display, stripbuf);
+  int checked = 0;
+  int failed = 0;
+  int written = 0;
+
+  auto check = [&](const char* name, auto&& render_fn,
+                   const char* ref = nullptr) {
+    if (filter && !std::strstr(name, filter)) return;
+    image got = render_fn();
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s/%s.j565", ref_dir, ref ? ref : name);
+    checked++;
+
+    if (update && !ref) {
+      if (!save_image(path, got)) {
+        std::printf("FAIL %s: cannot write %s\n", name, path);
+        failed++;
+      } else {
+        written++;
+      }
+      return;
+    }
+
+    image want;
+    if (!load_image(path, want)) {
+      std::printf("FAIL %s: missing or corrupt reference %s\n", name, path);
+      failed++;
+      return;
+    }
+    if (want.w != got.w || want.h != got.h) {
+      std::printf("FAIL %s: reference is %ux%u, rendered %ux%u\n", name,
+                  want.w, want.h, got.w, got.h);
+      failed++;
+      return;
+    }
+
+    std::vector<u16> diff;
+    report r = compare(want, got, diff);
+    if (r.differing == 0) return;
+
+    failed++;
+    std::printf(
+        "FAIL %s: %u px differ (%.3f%%), box (%d,%d)-(%d,%d), max channel "
+        "delta %u\n",
+        name, r.differing,
+        100.0 * r.differing / static_cast<double>(want.px.size()), r.x0,
+        r.y0, r.x1, r.y1, r.max_delta);
+    std::snprintf(path, sizeof(path), "%s/%s_expected.png", out_dir, name);
+    jhost::write_png(path, want.px.data(), want.w, want.h);
+    std::snprintf(path, sizeof(path), "%s/%s_actual.png", out_dir, name);
+    jhost::write_png(path, got.px.data(), got.w, got.h);
+    std::snprintf(path, sizeof(path), "%s/%s_diff.png", out_dir, name);
+    jhost::write_png(path, diff.data(), want.w, want.h);
+    std::printf("     wrote %s/%s_{expected,actual,diff}.png\n", out_dir, name);
+  };
+
+  for (const size_case& sz : sizes) {
+    display.set_size(sz.w, sz.h);
+    fb.reinit();
+    for (const theme_case& tc : theme_cases) {
+      char name[128];
+      for (i16 page = 0; page < jhost::page_count; ++page) {
+        std::snprintf(name, sizeof(name), "%s_%s_%ux%u", tc.name,
+                      jhost::page_names[page], sz.w, sz.h);
+        check(name, [&] { return render_page(fb, *tc.t, page); });
+      }
+      std::snprintf(name, sizeof(name), "%s_pressed_%ux%u", tc.name, sz.w,
+                    sz.h);
+      check(name, [&] { return render_pressed(fb, *tc.t); });
+    }
+
+    strips.reinit();
+    for (i16 page = 0; page < jhost::page_count; ++page) {
+      char name[128];
+      char strip[sizeof(name) + 6];
+      std::snprintf(name, sizeof(name), "mono_%s_%ux%u",
+                    jhost::page_names[page], sz.w, sz.h);
+      std::snprintf(strip, sizeof(strip), "%s_strip", name);
+      check(strip, [&] { return render_page(strips, themes::mono, page); },
+            name);
+    }
+  }
+
+  for (i16 page = 0; page < jhost::page_count; ++page) {
+    char name[128];
+    char tiles[128];
+    std::snprintf(name, sizeof(name), "mono_%s_320x240",
+                  jhost::page_names[page]);
+    std::snprintf(tiles, sizeof(tiles), "mono_%s_tiles",
+                  jhost::page_names[page]);
+    check(tiles, [&] { return render_tiles(themes::mono, page); }, name);
+  }
+
+  display.set_size(320, 240);
+  fb.reinit();
+  for (const theme_case& tc : theme_cases) {
+    char name[128];
+    std::snprintf(name, sizeof(name), "%s_primitives", tc.name);
+    check(name, [&] {
+      primitives(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+  }
+
+  for (const theme_case& tc : theme_cases) {
+    char name[128];
+    std::snprintf(name, sizeof(name), "%s_arcs", tc.name);
+    check(name, [&] {
+      arcs(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+    std::snprintf(name, sizeof(name), "%s_aa", tc.name);
+    check(name, [&] {
+      antialiased(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+    std::snprintf(name, sizeof(name), "%s_lists", tc.name);
+    check(name, [&] { return render_lists(fb, *tc.t); });
+    std::snprintf(name, sizeof(name), "%s_plots", tc.name);
+    check(name, [&] { return render_plots(fb, *tc.t, false); });
+    char full[128];
+    std::snprintf(full, sizeof(full), "%s_plots_repaint", tc.name);
+    check(full, [&] { return render_plots(fb, *tc.t, true); }, name);
+    std::snprintf(name, sizeof(name), "%s_kinetic", tc.name);
+    check(name, [&] { return render_kinetic(fb, *tc.t, fling::band); });
+    std::snprintf(full, sizeof(full), "%s_kinetic_repaint", tc.name);
+    check(full, [&] { return render_kinetic(fb, *tc.t, fling::repaint); },
+          name);
+    std::snprintf(full, sizeof(full), "%s_kinetic_hardware", tc.name);
+    check(full, [&] { return render_kinetic(fb, *tc.t, fling::hardware); },
+          name);
+    std::snprintf(name, sizeof(name), "%s_blend", tc.name);
+    check(name, [&] {
+      blended(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+    std::snprintf(name, sizeof(name), "%s_gradients", tc.name);
+    check(name, [&] {
+      gradients(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+    std::snprintf(name, sizeof(name), "%s_occluded", tc.name);
+    check(name, [&] {
+      occluded(fb, *tc.t);
+      fb.flush();
+      return grab();
+    });
+    std::snprintf(full, sizeof(full), "%s_occluded_culled", tc.name);
+    check(full, [&] { return render_culled(fb, *tc.t); }, name);
+  }
+
+  for (const font_case& fc : font_cases) {
+    for (i16 page = 0; page < jhost::page_count; ++page) {
+      char name[128];
+      std::snprintf(name, sizeof(name), "font_%s_%s", fc.name,
+                    jhost::page_names[page]);
+      check(name,
+            [&] { return render_font_page(fb, themes::dark, *fc.f, page); });
+    }
+  }
+
+  if (update)
+    std::printf("updated %d of %d references in %s\n", written, checked,
+                ref_dir);
+  else
+    std::printf("%d of %d scenes match\n", checked - failed, checked);
+  return failed == 0 && checked > 0 ? 0 : 1;
+}
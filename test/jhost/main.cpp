@@ -0,0 +1,43 @@
+#include <cstdio>
+#include <jemgui/jemgui.hpp>
+
+#include "mem_display.hpp"
+#include "screens.hpp"
+
+using namespace jemgui;
+
+JEMGUI_FRAMEBUF(framebuf, 320, 240);
+
+static jhost::mem_display display;
+
+int main(int argc, char** argv) {
+  const char* out_dir = argc > 1 ? argv[1] : ".";
+  bool ppm = argc > 2 && argv[2][0] == 'p';
+
+  canvas<jhost::mem_display> fb(display, framebuf);
+  ctx ui(fb);
+
+  const theme* themes_list[] = {&themes::dark, &themes::light};
+  const char* theme_names[] = {"dark", "light"};
+
+  for (usize t = 0; t < 2; ++t) {
+    ui.set_theme(*themes_list[t]);
+    jhost::demo_state st;
+    for (i16 page = 0; page < jhost::page_count; ++page) {
+      st.page = page;
+      for (int i = 0; i < 60; ++i) {
+        jhost::demo_frame(ui, st, input_state{});
+        fb.flush();
+      }
+
+      char path[256];
+      std::snprintf(path, sizeof(path), "%s/%s_%s.%s", out_dir,
+                    theme_names[t], jhost::page_names[page],
+                    ppm ? "ppm" : "png");
+      bool ok = ppm ? display.write_ppm(path) : display.write_png(path);
+      std::printf("%s %s\n", ok ? "wrote" : "failed", path);
+      if (!ok) return 1;
+    }
+  }
+  return 0;
+}
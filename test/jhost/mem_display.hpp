@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <jemgui/jemgui.hpp>
+#include <vector>
+
+namespace jhost {
+
+using namespace jemgui;
+
+namespace detail {
+
+inline void put_be32(std::vector<u8>& v, u32 x) {
+  v.push_back(static_cast<u8>(x >> 24));
+  v.push_back(static_cast<u8>(x >> 16));
+  v.push_back(static_cast<u8>(x >> 8));
+  v.push_back(static_cast<u8>(x));
+}
+
+inline u32 crc32(u32 crc, const u8* data, usize n) {
+  crc = ~crc;
+  for (usize i = 0; i < n; ++i) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+  }
+  return ~crc;
+}
+
+inline void write_chunk(std::FILE* f, const char* type,
+                        const std::vector<u8>& data) {
+  std::vector<u8> buf;
+  put_be32(buf, static_cast<u32>(data.size()));
+  buf.insert(buf.end(), type, type + 4);
+  buf.insert(buf.end(), data.begin(), data.end());
+  put_be32(buf, crc32(0, buf.data() + 4, buf.size() - 4));
+  std::fwrite(buf.data(), 1, buf.size(), f);
+}
+
+}  // namespace detail
+
+inline bool write_ppm(const char* path, const u16* px, u16 w, u16 h) {
+  std::FILE* f = std::fopen(path, "wb");
+  if (!f) return false;
+  std::fprintf(f, "P6\n%u %u\n255\n", w, h);
+  for (u32 i = 0; i < static_cast<u32>(w) * h; ++i) {
+    u8 rgb[3] = {rgb565_r(px[i]), rgb565_g(px[i]), rgb565_b(px[i])};
+    std::fwrite(rgb, 1, 3, f);
+  }
+  return std::fclose(f) == 0;
+}
+
+inline bool write_png(const char* path, const u16* px, u16 w, u16 h) {
+  std::vector<u8> raw;
+  raw.reserve(static_cast<usize>(h) * (1 + w * 3));
+  for (u32 i = 0; i < static_cast<u32>(w) * h; ++i) {
+    if (i % w == 0) raw.push_back(0);
+    raw.push_back(rgb565_r(px[i]));
+    raw.push_back(rgb565_g(px[i]));
+    raw.push_back(rgb565_b(px[i]));
+  }
+
+  std::vector<u8> z = {0x78, 0x01};
+  usize at = 0;
+  do {
+    usize n = std::min<usize>(65535, raw.size() - at);
+    bool last = at + n == raw.size();
+    z.push_back(last ? 1 : 0);
+    z.push_back(static_cast<u8>(n));
+    z.push_back(static_cast<u8>(n >> 8));
+    z.push_back(static_cast<u8>(~n));
+    z.push_back(static_cast<u8>(~n >> 8));
+    z.insert(z.end(), raw.begin() + static_cast<long>(at),
+             raw.begin() + static_cast<long>(at + n));
+    at += n;
+  } while (at < raw.size());
+  u32 a = 1;
+  u32 b = 0;
+  for (u8 v : raw) {
+    a = (a + v) % 65521;
+    b = (b + a) % 65521;
+  }
+  detail::put_be32(z, (b << 16) | a);
+
+  std::vector<u8> ihdr;
+  detail::put_be32(ihdr, w);
+  detail::put_be32(ihdr, h);
+  ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});
+
+  std::FILE* f = std::fopen(path, "wb");
+  if (!f) return false;
+  static constexpr u8 sig[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::fwrite(sig, 1, sizeof(sig), f);
+  detail::write_chunk(f, "IHDR", ihdr);
+  detail::write_chunk(f, "IDAT", z);
+  detail::write_chunk(f, "IEND", {});
+  return std::fclose(f) == 0;
+}
+
+class mem_display {
+ public:
+  static constexpr u16 max_w = 480;
+  static constexpr u16 max_h = 480;
+
+  mem_display(u16 w = 320, u16 h = 240) : w_{w}, h_{h} {}
+
+  u16 width() const { return w_; }
+  u16 height() const { return h_; }
+
+  void set_size(u16 w, u16 h) {
+    w_ = w;
+    h_ = h;
+  }
+
+  void blit(u16 x, u16 y, u16 w, u16 h, const u16* data) {
+    blit(x, y, w, h, data, w);
+  }
+
+  void blit(u16 x, u16 y, u16 w, u16 h, const u16* data, u16 stride) {
+    blits_++;
+    pixels_ += static_cast<u64>(w) * h;
+    for (u16 j = 0; j < h; ++j)
+      std::memcpy(&px_[(y + j) * w_ + x], data + j * stride, w * sizeof(u16));
+  }
+
+  void enable_scroll(bool on) { scroll_ = on; }
+
+  bool scroll_rows(u16 top, u16 h, i16 dy) {
+    if (!scroll_) return false;
+    scrolls_++;
+    u16 n = static_cast<u16>(h - (dy < 0 ? -dy : dy));
+    u16 from = dy > 0 ? top : static_cast<u16>(top - dy);
+    u16 to = dy > 0 ? static_cast<u16>(top + dy) : top;
+    std::memmove(&px_[to * w_], &px_[from * w_],
+                 static_cast<usize>(n) * w_ * sizeof(u16));
+    return true;
+  }
+
+  u16 at(u16 x, u16 y) const { return px_[y * w_ + x]; }
+  const u16* pixels() const { return px_; }
+
+  u64 blits() const { return blits_; }
+  u64 pixels_sent() const { return pixels_; }
+  u64 scrolls() const { return scrolls_; }
+
+  void reset_counters() {
+    blits_ = 0;
+    pixels_ = 0;
+    scrolls_ = 0;
+  }
+
+  bool write_ppm(const char* path) const {
+    return jhost::write_ppm(path, px_, w_, h_);
+  }
+
+  bool write_png(const char* path) const {
+    return jhost::write_png(path, px_, w_, h_);
+  }
+
+ private:
+  u16 w_;
+  u16 h_;
+  u16 px_[max_w * max_h] = {};
+  u64 blits_ = 0;
+  u64 pixels_ = 0;
+  u64 scrolls_ = 0;
+  bool scroll_ = false;
+};
+
+}  // namespace jhost
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstdio>
+#include <jemgui/jemgui.hpp>
+
+namespace jhost {
+
+using namespace jemgui;
+
+inline constexpr i16 page_count = 4;
+inline constexpr const char* page_names[page_count] = {"wdg", "dash", "home",
+                                                       "ctrl"};
+
+struct demo_state {
+  i16 page = 0;
+
+  bool toggle_a = false;
+  bool toggle_b = true;
+  bool check_a = true;
+  bool check_b = false;
+  i16 radio_val = 0;
+  i16 slider_val = 50;
+  i16 slider_b = 25;
+  float progress_val = 0.4f;
+
+  i16 speed = 35;
+  i16 distance = 125;
+  i16 ride_time = 42;
+  i16 battery = 78;
+
+  i16 selected_file = 0;
+  i16 copies = 1;
+  bool duplex = false;
+  bool high_quality = true;
+
+  bool led_g = false;
+  bool led_b = false;
+  bool led_r = false;
+
+  u32 frame = 0;
+};
+
+template <painter P>
+void demo_frame(ctx<P>& ui, demo_state& st, const input_state& input,
+                i32 dt = 16) {
+  ui.begin_frame(input, dt);
+
+  {
+    auto& p = ui.painter();
+    i16 nav_h =
+        jemgui::scale(static_cast<i16>(ui.current_theme().padding * 2 +
+                                       ui.current_theme().widget_height),
+                      ui.scale_value());
+    p.fill_rect(0, 0, static_cast<i16>(p.width()), nav_h,
+                ui.current_theme().bg);
+  }
+
+  ui.row();
+  for (i16 i = 0; i < page_count; ++i) {
+    u16 c = (st.page == i) ? ui.current_theme().accent
+                           : ui.current_theme().surface_alt;
+    if (ui.button_colored(page_names[i], c)) st.page = i;
+  }
+  ui.end();
+
+  ui.push_id(st.page);
+  ui.panel_begin(nullptr);
+
+  if (st.page == 0) {
+    ui.row();
+    ui.button("light");
+    ui.button("rotate");
+    ui.label_fmt("f:{}", st.frame);
+    ui.end();
+
+    ui.separator();
+    ui.toggle("enable", st.toggle_a);
+    ui.toggle("animate", st.toggle_b);
+    ui.separator();
+    ui.checkbox("option a", st.check_a);
+    ui.checkbox("option b", st.check_b);
+    ui.separator();
+    ui.radio("choice 1", st.radio_val, 0);
+    ui.radio("choice 2", st.radio_val, 1);
+    ui.separator();
+    ui.slider("value", st.slider_val, 0, 100);
+    ui.slider("speed", st.slider_b, 0, 50);
+    ui.separator();
+    ui.progress("load", st.progress_val);
+    ui.separator();
+
+    ui.row(16);
+    ui.badge("ok", ui.current_theme().success);
+    ui.badge("warn", ui.current_theme().warning);
+    ui.badge("err", ui.current_theme().danger);
+    ui.badge("info", ui.current_theme().accent);
+    ui.end();
+
+    ui.separator();
+
+    ui.row();
+    ui.toggle("g", st.led_g);
+    ui.toggle("b", st.led_b);
+    ui.toggle("r", st.led_r);
+    ui.end();
+  } else if (st.page == 1) {
+    ui.header("DASHBOARD");
+    ui.spacer(4);
+
+    {
+      i16 sv = ui.scale_value();
+      i16 outer = jemgui::scale(28, sv);
+      i16 inner = jemgui::scale(20, sv);
+      i16 gap = jemgui::scale(3, sv);
+      i16 unit_h = draw::text_height(1);
+
+      i16 area_top = ui.cursor().y;
+      i16 area_cx = static_cast<i16>(ui.cursor().x + ui.available().w / 2);
+
+      ui.spacer(76);
+
+      i16 gcy = static_cast<i16>(area_top + outer + jemgui::scale(2, sv));
+      i16 gcx = area_cx;
+      float gf = static_cast<float>(st.speed) / 60.0f;
+      ui.gauge(gcx, gcy, outer, inner, gf, ui.current_theme().accent,
+               ui.current_theme().surface_alt);
+
+      char vbuf[8];
+      std::snprintf(vbuf, sizeof(vbuf), "%d", st.speed);
+      u8 vfs = static_cast<u8>(jemgui::scale(2, sv));
+      if (vfs < 1) vfs = 1;
+      i16 vtw = draw::text_width(vbuf, vfs);
+      i16 vth = draw::text_height(vfs);
+      rect vr = {
+          {static_cast<i16>(gcx - vtw / 2), static_cast<i16>(gcy - vth / 2)},
+          {static_cast<u16>(vtw), static_cast<u16>(vth)}};
+      draw::text_centered(ui.painter(), vr, vbuf, ui.current_theme().text,
+                          vfs);
+
+      i16 uty = static_cast<i16>(gcy + outer + gap);
+      i16 utw = draw::text_width("km/h", 1);
+      rect ur = {{static_cast<i16>(gcx - utw / 2), uty},
+                 {static_cast<u16>(utw), static_cast<u16>(unit_h)}};
+      draw::text_centered(ui.painter(), ur, "km/h",
+                          ui.current_theme().text_dim, 1);
+    }
+
+    ui.spacer(4);
+
+    {
+      i16 cw = 94;
+      i16 ch = 36;
+      char dbuf[16];
+      char tbuf[16];
+      std::snprintf(dbuf, sizeof(dbuf), "%d.%d", st.distance / 10,
+                    st.distance % 10);
+      std::snprintf(tbuf, sizeof(tbuf), "%dm", st.ride_time);
+
+      ui.row(ch);
+      ui.col(cw);
+      ui.stat_card("SPEED", "35", ui.current_theme().accent);
+      ui.end();
+      ui.col(cw);
+      ui.stat_card("DIST", dbuf, ui.current_theme().success);
+      ui.end();
+      ui.col(cw);
+      ui.stat_card("TIME", tbuf, ui.current_theme().warning);
+      ui.end();
+      ui.end();
+    }
+
+    ui.spacer(4);
+    ui.progress("bat", static_cast<float>(st.battery) / 100.0f);
+    ui.spacer(4);
+    ui.slider("spd", st.speed, 0, 60);
+  } else if (st.page == 2) {
+    u16 aw = ui.available().w;
+    i16 sv = ui.scale_value();
+    i16 sp = jemgui::scale(ui.current_theme().spacing, sv);
+    u16 tw = static_cast<u16>((aw - sp) / 2);
+    i16 th = jemgui::scale(78, sv);
+
+    ui.row(78);
+    if (ui.tile("COPY", rgb565(120, 80, 200), tw, th)) st.led_g = !st.led_g;
+    if (ui.tile("SCAN", rgb565(60, 140, 220), tw, th)) st.led_b = !st.led_b;
+    ui.end();
+
+    ui.row(78);
+    if (ui.tile("PRINT", rgb565(60, 180, 100), tw, th)) st.led_r = !st.led_r;
+    if (ui.tile("SETUP", rgb565(220, 100, 60), tw, th)) st.page = 3;
+    ui.end();
+
+    ui.spacer(8);
+    ui.label("tap tiles to toggle LEDs");
+  } else if (st.page == 3) {
+    ui.header("PRINT SETTINGS", rgb565(60, 100, 200));
+    ui.spacer(4);
+
+    ui.label("select file");
+    static const char* files[] = {"report.pdf", "photo.jpg", "design.png",
+                                  "notes.txt"};
+    for (i16 i = 0; i < 4; ++i) {
+      if (ui.list_item(files[i], st.selected_file == i)) st.selected_file = i;
+    }
+
+    ui.separator();
+    ui.spinner("copies", st.copies, 1, 99);
+    ui.toggle("duplex", st.duplex);
+    ui.toggle("high quality", st.high_quality);
+    ui.spacer(4);
+    ui.button_fill_colored("START PRINT", ui.current_theme().success);
+  }
+
+  ui.panel_end();
+  ui.pop_id();
+  ui.end_frame();
+  ++st.frame;
+}
+
+}  // namespace jhost
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <jemgui/anim.hpp>
+#include <jemgui/state_table.hpp>
+
+using namespace jemgui;
+
+static int failed = 0;
+static int checked = 0;
+
+static void expect(bool ok, const char* what) {
+  checked++;
+  if (ok) return;
+  failed++;
+  std::printf("FAIL %s\n", what);
+}
+
+struct counter {
+  i32 n = 0;
+};
+
+int main() {
+  {
+    state_table<id, counter, 8> t;
+    expect(t.find(42) == nullptr, "find on empty table");
+    t.get(42)->n = 7;
+    t.get(1042)->n = 9;
+    expect(t.find(42) && t.find(42)->n == 7, "value kept");
+    expect(t.find(1042) && t.find(1042)->n == 9, "second key kept");
+    expect(t.size() == 2, "size after two inserts");
+    expect(t.erase(42) && !t.find(42), "erase");
+    expect(t.find(1042) && t.find(1042)->n == 9, "probe past erased slot");
+    expect(t.get(42)->n == 0, "reinsert starts from a fresh value");
+    i32 sum = 0;
+    for (const counter& c : t) sum += c.n;
+    expect(sum == 9, "iteration visits live entries only");
+  }
+
+  {
+    state_table<id, counter, 4> t;
+    for (id k = 1; k <= 4; ++k) t.get(k * 977)->n = static_cast<i32>(k);
+    expect(t.get(5 * 977) == nullptr, "full table keeps entries touched now");
+    t.tick();
+    expect(t.get(5 * 977) == nullptr, "entries from last frame stay");
+    t.tick();
+    t.get(2 * 977);
+    t.get(3 * 977);
+    t.get(4 * 977);
+    counter* c = t.get(5 * 977);
+    expect(c && c->n == 0, "stale entry evicted for a new key");
+    expect(!t.find(977), "evicted key is gone");
+    expect(t.find(3 * 977) && t.find(3 * 977)->n == 3, "live entries survive");
+    expect(t.size() == 4, "size after eviction");
+    t.clear();
+    expect(t.size() == 0 && !t.find(3 * 977), "clear");
+  }
+
+  {
+    anim_pool a;
+    a.ensure(7, 256, 100);
+    expect(a.get(7, -1) == 256 && !a.any_active(), "first ensure settles");
+    a.ensure(7, 0, 100);
+    expect(a.running(7) && a.active_count() == 1, "retarget starts");
+    a.tick(50);
+    i32 mid = a.get(7, -1);
+    expect(mid > 0 && mid < 256, "halfway value");
+    a.tick(60);
+    expect(a.get(7, -1) == 0 && !a.any_active(), "finished");
+    expect(a.get(8, -1) == -1, "unknown target falls back");
+  }
+
+  {
+    anim_pool a;
+    for (id k = 1; k <= anim_pool::max_anims; ++k) a.ensure(k, 0, 100);
+    a.ensure(1, 256, 100);
+    expect(a.active_count() == 1, "one running animation");
+    a.tick(0);
+    a.tick(0);
+    for (id k = 2; k <= anim_pool::max_anims; ++k) a.ensure(k, 0, 100);
+    a.ensure(1000, 256, 100);
+    expect(!a.running(1), "stale running animation evicted");
+    expect(a.active_count() == 0 && !a.any_active(),
+           "evicting a running animation drops it from the count");
+  }
+
+  std::printf("%d of %d state_table checks pass\n", checked - failed, checked);
+  return failed == 0 ? 0 : 1;
+}
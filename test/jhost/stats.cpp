@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstdio>
+#include <jemgui/jemgui.hpp>
+
+#include "mem_display.hpp"
+#include "screens.hpp"
+
+using namespace jemgui;
+
+JEMGUI_FRAMEBUF(framebuf, 320, 240);
+
+static jhost::mem_display display;
+
+static int failed = 0;
+static int checked = 0;
+
+static void expect(bool ok, const char* what) {
+  checked++;
+  if (ok) return;
+  failed++;
+  std::printf("FAIL %s\n", what);
+}
+
+static u32 now_ns() {
+  using namespace std::chrono;
+  return static_cast<u32>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+          .count());
+}
+
+static void row(const char* name, const prim_stats& p) {
+  std::printf("  %-10s %8lu calls %10lu px\n", name,
+              static_cast<unsigned long>(p.calls),
+              static_cast<unsigned long>(p.px));
+}
+
+int main(int argc, char** argv) {
+  const char* out_dir = argc > 1 ? argv[1] : nullptr;
+
+  canvas<jhost::mem_display> fb(display, framebuf);
+
+  {
+    ctx still(fb);
+    still.set_frame_skip(true);
+    auto frame = [&] {
+      still.begin_frame(input_state{});
+      still.label("still");
+      still.button("ok");
+      still.end_frame();
+      fb.flush();
+    };
+    frame();
+    frame();
+    expect(still.stats().paint.fill_rect.px > 0,
+           "first frame counts fill_rect pixels");
+    bool skipped = false;
+    for (int i = 0; i < 4 && !skipped; ++i) {
+      frame();
+      skipped = !still.painting();
+    }
+    expect(skipped, "unchanged frame is skipped");
+    frame();
+    expect(still.stats().paint.total_px() == 0 &&
+               still.stats().paint.dirty_px == 0,
+           "skipped frame draws no pixels");
+    still.invalidate();
+    frame();
+    expect(still.painting(), "invalidate paints the next frame");
+  }
+
+  ctx ui(fb);
+  ui.set_clock(now_ns);
+
+  for (i16 page = 0; page < jhost::page_count; ++page) {
+    jhost::demo_state st;
+    st.page = page;
+    for (int i = 0; i < 3; ++i) {
+      jhost::demo_frame(ui, st, input_state{});
+      fb.flush();
+    }
+
+    ui.begin_frame(input_state{});
+    ui.stats_overlay();
+    ui.end_frame();
+    fb.flush();
+
+    const frame_stats& s = ui.stats();
+    const paint_stats& p = s.paint;
+    std::printf(
+        "%s: %lu widgets (%lu culled), %lu anims, %lu text misses, %lu px "
+        "drawn, %lu clip rejects\n",
+        jhost::page_names[page], static_cast<unsigned long>(s.widgets),
+        static_cast<unsigned long>(s.culled),
+        static_cast<unsigned long>(s.anims_active),
+        static_cast<unsigned long>(s.text_misses),
+        static_cast<unsigned long>(p.total_px()),
+        static_cast<unsigned long>(p.clip_rejects));
+    row("fill_rect", p.fill_rect);
+    row("hline", p.hline);
+    row("vline", p.vline);
+    row("pixel", p.pixel);
+    row("circle", p.circle);
+    row("glyph", p.glyph);
+    std::printf("  dirty      %8lu rects %9lu px\n",
+                static_cast<unsigned long>(p.dirty_rects),
+                static_cast<unsigned long>(p.dirty_px));
+    std::printf("  ns         begin %lu widgets %lu end %lu flush %lu\n",
+                static_cast<unsigned long>(s.begin_cycles),
+                static_cast<unsigned long>(s.widget_cycles),
+                static_cast<unsigned long>(s.end_cycles),
+                static_cast<unsigned long>(p.flush_cycles));
+
+    if (out_dir) {
+      char path[256];
+      std::snprintf(path, sizeof(path), "%s/stats_%s.png", out_dir,
+                    jhost::page_names[page]);
+      display.write_png(path);
+    }
+  }
+  std::printf("%d of %d stats checks pass\n", checked - failed, checked);
+  return failed == 0 ? 0 : 1;
+}
@@ -159,7 +159,7 @@ int main() {
         fb.reinit();
         ui.recalculate();
       }
-      ui.label_fmt("f:%lu", frame);
+      ui.label_fmt("f:{}", frame);
       ui.end();
 
       ui.separator();
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if JEMGUI_FONTC_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+struct glyph {
+  int w = 0;
+  int h = 0;
+  int x = 0;
+  int y = 0;
+  int advance = 0;
+  std::vector<uint8_t> gray;
+};
+
+struct face {
+  int ascent = 0;
+  int line_height = 0;
+  std::vector<glyph> glyphs;
+};
+
+struct options {
+  std::string input;
+  std::string name;
+  int size = 16;
+  int bpp = 1;
+  int scale = 1;
+  int downsample = 1;
+  int first = 32;
+  int last = 126;
+};
+
+static bool ends_with(const std::string& s, const char* suffix) {
+  size_t n = std::strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool load_bdf(const options& opt, face& out) {
+  std::ifstream in(opt.input);
+  if (!in) return false;
+
+  int descent = 0;
+  out.glyphs.assign(static_cast<size_t>(opt.last - opt.first + 1), glyph{});
+  std::string line;
+  int code = -1;
+  glyph g;
+  int by = 0;
+  while (std::getline(in, line)) {
+    std::istringstream ss(line);
+    std::string key;
+    ss >> key;
+    if (key == "FONT_ASCENT") {
+      ss >> out.ascent;
+    } else if (key == "FONT_DESCENT") {
+      ss >> descent;
+    } else if (key == "STARTCHAR") {
+      code = -1;
+      g = glyph{};
+    } else if (key == "ENCODING") {
+      ss >> code;
+    } else if (key == "DWIDTH") {
+      ss >> g.advance;
+    } else if (key == "BBX") {
+      ss >> g.w >> g.h >> g.x >> by;
+      g.gray.assign(static_cast<size_t>(g.w * g.h), 0);
+    } else if (key == "BITMAP") {
+      for (int row = 0; row < g.h && std::getline(in, line); ++row) {
+        for (int col = 0; col < g.w; ++col) {
+          size_t digit = static_cast<size_t>(col / 4);
+          if (digit >= line.size()) break;
+          int v = std::stoi(line.substr(digit, 1), nullptr, 16);
+          if (v & (8 >> (col % 4)))
+            g.gray[static_cast<size_t>(row * g.w + col)] = 255;
+        }
+      }
+    } else if (key == "ENDCHAR") {
+      if (code >= opt.first && code <= opt.last) {
+        g.y = out.ascent - (by + g.h);
+        out.glyphs[static_cast<size_t>(code - opt.first)] = g;
+      }
+    }
+  }
+  out.line_height = out.ascent + descent;
+  return out.line_height > 0;
+}
+
+#if JEMGUI_FONTC_FREETYPE
+static bool load_freetype(const options& opt, face& out) {
+  FT_Library lib;
+  FT_Face ft;
+  if (FT_Init_FreeType(&lib)) return false;
+  if (FT_New_Face(lib, opt.input.c_str(), 0, &ft)) {
+    FT_Done_FreeType(lib);
+    return false;
+  }
+  FT_Set_Pixel_Sizes(ft, 0, static_cast<FT_UInt>(opt.size));
+  out.ascent = static_cast<int>(ft->size->metrics.ascender >> 6);
+  out.line_height = static_cast<int>(ft->size->metrics.height >> 6);
+  for (int c = opt.first; c <= opt.last; ++c) {
+    glyph g;
+    if (FT_Load_Char(ft, static_cast<FT_ULong>(c), FT_LOAD_RENDER) == 0) {
+      FT_Bitmap& bm = ft->glyph->bitmap;
+      g.w = static_cast<int>(bm.width);
+      g.h = static_cast<int>(bm.rows);
+      g.x = ft->glyph->bitmap_left;
+      g.y = out.ascent - ft->glyph->bitmap_top;
+      g.advance = static_cast<int>((ft->glyph->advance.x + 32) >> 6);
+      g.gray.resize(static_cast<size_t>(g.w * g.h));
+      bool mono = bm.pixel_mode == FT_PIXEL_MODE_MONO;
+      for (int y = 0; y < g.h; ++y) {
+        const uint8_t* row = bm.buffer + y * bm.pitch;
+        for (int x = 0; x < g.w; ++x) {
+          uint8_t v = mono ? ((row[x / 8] >> (7 - x % 8)) & 1 ? 255 : 0)
+                           : row[x];
+          g.gray[static_cast<size_t>(y * g.w + x)] = v;
+        }
+      }
+    }
+    out.glyphs.push_back(g);
+  }
+  FT_Done_Face(ft);
+  FT_Done_FreeType(lib);
+  return true;
+}
+#endif
+
+static int div_floor(int a, int b) {
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static int div_ceil(int a, int b) { return -div_floor(-a, b); }
+
+static void resample(face& f, int scale, int down) {
+  for (glyph& g : f.glyphs) {
+    int x0 = div_floor(g.x * scale, down);
+    int y0 = div_floor(g.y * scale, down);
+    int x1 = div_ceil((g.x + g.w) * scale, down);
+    int y1 = div_ceil((g.y + g.h) * scale, down);
+    glyph r;
+    r.x = x0;
+    r.y = y0;
+    r.w = std::max(0, x1 - x0);
+    r.h = std::max(0, y1 - y0);
+    r.advance = div_floor(g.advance * scale + down / 2, down);
+    r.gray.assign(static_cast<size_t>(r.w * r.h), 0);
+    for (int y = 0; y < r.h; ++y) {
+      for (int x = 0; x < r.w; ++x) {
+        int sum = 0;
+        for (int sy = 0; sy < down; ++sy) {
+          int ry = (y0 + y) * down + sy - g.y * scale;
+          if (ry < 0 || ry >= g.h * scale) continue;
+          for (int sx = 0; sx < down; ++sx) {
+            int rx = (x0 + x) * down + sx - g.x * scale;
+            if (rx < 0 || rx >= g.w * scale) continue;
+            sum += g.gray[static_cast<size_t>((ry / scale) * g.w + rx / scale)];
+          }
+        }
+        r.gray[static_cast<size_t>(y * r.w + x)] =
+            static_cast<uint8_t>(sum / (down * down));
+      }
+    }
+    g = r;
+  }
+  f.ascent = div_ceil(f.ascent * scale, down);
+  f.line_height = div_ceil(f.line_height * scale, down);
+}
+
+static int quantize(uint8_t v, int bpp) {
+  if (bpp == 1) return v >= 128 ? 1 : 0;
+  return (v + 42) / 85;
+}
+
+static void trim(glyph& g, int bpp) {
+  int x0 = g.w;
+  int y0 = g.h;
+  int x1 = -1;
+  int y1 = -1;
+  for (int y = 0; y < g.h; ++y) {
+    for (int x = 0; x < g.w; ++x) {
+      if (!quantize(g.gray[static_cast<size_t>(y * g.w + x)], bpp)) continue;
+      x0 = std::min(x0, x);
+      y0 = std::min(y0, y);
+      x1 = std::max(x1, x);
+      y1 = std::max(y1, y);
+    }
+  }
+  if (x1 < 0) {
+    g.w = 0;
+    g.h = 0;
+    g.gray.clear();
+    return;
+  }
+  std::vector<uint8_t> out;
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x)
+      out.push_back(g.gray[static_cast<size_t>(y * g.w + x)]);
+  g.x += x0;
+  g.y += y0;
+  g.w = x1 - x0 + 1;
+  g.h = y1 - y0 + 1;
+  g.gray = std::move(out);
+}
+
+static void emit(const options& opt, const face& f) {
+  std::vector<uint8_t> bits;
+  std::vector<uint32_t> offsets;
+  for (const glyph& g : f.glyphs) {
+    offsets.push_back(static_cast<uint32_t>(bits.size()));
+    uint32_t acc = 0;
+    int filled = 0;
+    for (uint8_t v : g.gray) {
+      acc = (acc << opt.bpp) | static_cast<uint32_t>(quantize(v, opt.bpp));
+      filled += opt.bpp;
+      if (filled == 8) {
+        bits.push_back(static_cast<uint8_t>(acc));
+        acc = 0;
+        filled = 0;
+      }
+    }
+    if (filled) bits.push_back(static_cast<uint8_t>(acc << (8 - filled)));
+  }
+  if (bits.empty()) bits.push_back(0);
+
+  const char* n = opt.name.c_str();
+  std::printf("#pragma once\n\n#include <jemgui/font.hpp>\n\n");
+  std::printf("inline constexpr jemgui::u8 %s_bitmap[] = {", n);
+  for (size_t i = 0; i < bits.size(); ++i)
+    std::printf("%s0x%02X,", i % 12 ? " " : "\n    ", bits[i]);
+  std::printf("\n};\n\n");
+
+  std::printf("inline constexpr jemgui::font_glyph %s_glyphs[] = {\n", n);
+  for (size_t i = 0; i < f.glyphs.size(); ++i) {
+    const glyph& g = f.glyphs[i];
+    std::printf("    {%u, %d, %d, %d, %d, %d},\n", offsets[i], g.w, g.h, g.x,
+                g.y, std::max(0, g.advance));
+  }
+  std::printf("};\n\n");
+
+  std::printf(
+      "inline constexpr jemgui::font %s = {\n"
+      "    .bitmap = %s_bitmap,\n"
+      "    .glyphs = %s_glyphs,\n"
+      "    .first = %d,\n"
+      "    .last = %d,\n"
+      "    .bpp = %d,\n"
+      "    .line_height = %d,\n"
+      "    .baseline = %d,\n"
+      "};\n",
+      n, n, n, opt.first, opt.last, opt.bpp, f.line_height, f.ascent);
+}
+
+static int usage() {
+  std::fprintf(stderr,
+               "usage: jemgui_fontc <font.bdf|font.ttf> <name> [--size px] "
+               "[--bpp 1|2]\n"
+               "                    [--scale n] [--downsample n] "
+               "[--first c] [--last c]\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  options opt;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto value = [&](int& dst) {
+      if (i + 1 >= argc) return false;
+      dst = std::atoi(argv[++i]);
+      return true;
+    };
+    bool ok = true;
+    if (a == "--size")
+      ok = value(opt.size);
+    else if (a == "--bpp")
+      ok = value(opt.bpp);
+    else if (a == "--scale")
+      ok = value(opt.scale);
+    else if (a == "--downsample")
+      ok = value(opt.downsample);
+    else if (a == "--first")
+      ok = value(opt.first);
+    else if (a == "--last")
+      ok = value(opt.last);
+    else
+      positional.push_back(a);
+    if (!ok) return usage();
+  }
+  if (positional.size() != 2 || (opt.bpp != 1 && opt.bpp != 2) ||
+      opt.scale < 1 || opt.downsample < 1 || opt.first > opt.last ||
+      opt.first < 0 || opt.last > 255)
+    return usage();
+  opt.input = positional[0];
+  opt.name = positional[1];
+
+  face f;
+  bool loaded = false;
+  if (ends_with(opt.input, ".bdf")) {
+    loaded = load_bdf(opt, f);
+  } else {
+#if JEMGUI_FONTC_FREETYPE
+    loaded = load_freetype(opt, f);
+#else
+    std::fprintf(stderr, "built without freetype, only .bdf is supported\n");
+    return 1;
+#endif
+  }
+  if (!loaded) {
+    std::fprintf(stderr, "cannot load %s\n", opt.input.c_str());
+    return 1;
+  }
+
+  if (opt.scale != 1 || opt.downsample != 1)
+    resample(f, opt.scale, opt.downsample);
+  for (glyph& g : f.glyphs) {
+    trim(g, opt.bpp);
+    if (g.w > 255 || g.h > 255 || g.x < -128 || g.x > 127 || g.y < -128 ||
+        g.y > 127 || g.advance > 255) {
+      std::fprintf(stderr, "glyph too large for the font format\n");
+      return 1;
+    }
+  }
+  if (f.line_height > 255 || f.ascent > 255) {
+    std::fprintf(stderr, "line height too large for the font format\n");
+    return 1;
+  }
+  emit(opt, f);
+  return 0;
+}